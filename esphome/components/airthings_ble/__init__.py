@@ -20,4 +20,4 @@ CONFIG_SCHEMA = cv.Schema(
 
 def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
-    yield esp32_ble_tracker.register_ble_device(var, config)
+    yield esp32_ble_tracker.register_ble_device(var, config, manufacturer_id=0x0334)
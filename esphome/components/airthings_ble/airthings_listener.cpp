@@ -9,19 +9,20 @@ namespace airthings_ble {
 static const char *const TAG = "airthings_ble";
 
 bool AirthingsListener::parse_device(const esp32_ble_tracker::ESPBTDevice &device) {
-  for (auto &it : device.get_manufacturer_datas()) {
-    if (it.uuid == esp32_ble_tracker::ESPBTUUID::from_uint32(0x0334)) {
-      if (it.data.size() < 4)
-        continue;
-
-      uint32_t sn = it.data[0];
-      sn |= ((uint32_t) it.data[1] << 8);
-      sn |= ((uint32_t) it.data[2] << 16);
-      sn |= ((uint32_t) it.data[3] << 24);
-
-      ESP_LOGD(TAG, "Found AirThings device Serial:%u (MAC: %s)", sn, device.address_str().c_str());
-      return true;
-    }
+  for (const auto &record : device.get_adv_data()) {
+    // company identifier (little endian) followed by the serial number
+    if (record.type != ESP_BLE_AD_MANUFACTURER_SPECIFIC_TYPE || record.length < 6)
+      continue;
+    if (record.data[0] != 0x34 || record.data[1] != 0x03)
+      continue;
+
+    uint32_t sn = record.data[2];
+    sn |= ((uint32_t) record.data[3] << 8);
+    sn |= ((uint32_t) record.data[4] << 16);
+    sn |= ((uint32_t) record.data[5] << 24);
+
+    ESP_LOGD(TAG, "Found AirThings device Serial:%u (MAC: %s)", sn, device.address_str().c_str());
+    return true;
   }
 
   return false;
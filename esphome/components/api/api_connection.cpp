@@ -88,7 +88,7 @@ void APIConnection::loop() {
   } else {
     this->last_traffic_ = millis();
     // read a packet
-    this->read_message(buffer.data_len, buffer.type, &buffer.container[buffer.data_offset]);
+    this->read_message(buffer.data_len, buffer.type, buffer.data);
     if (this->remove_)
       return;
   }
@@ -829,7 +829,7 @@ void APIConnection::on_get_time_response(const GetTimeResponse &value) {
 
 #ifdef USE_BLUETOOTH_PROXY
 bool APIConnection::send_bluetooth_le_advertisement(const BluetoothLEAdvertisementResponse &msg) {
-  if (!this->bluetooth_le_advertisement_subscription_)
+  if (!this->is_bluetooth_le_advertisement_subscribed(false))
     return false;
   if (this->client_api_version_major_ < 1 || this->client_api_version_minor_ < 7) {
     BluetoothLEAdvertisementResponse resp = msg;
@@ -845,6 +845,11 @@ bool APIConnection::send_bluetooth_le_advertisement(const BluetoothLEAdvertiseme
   }
   return this->send_bluetooth_le_advertisement_response(msg);
 }
+bool APIConnection::send_bluetooth_le_raw_advertisements(const BluetoothLERawAdvertisementsResponse &msg) {
+  if (!this->is_bluetooth_le_advertisement_subscribed(true))
+    return false;
+  return this->send_bluetooth_le_raw_advertisements_response(msg);
+}
 void APIConnection::bluetooth_device_request(const BluetoothDeviceRequest &msg) {
   bluetooth_proxy::global_bluetooth_proxy->bluetooth_device_request(msg);
 }
@@ -890,6 +895,42 @@ bool APIConnection::send_log_message(int level, const char *tag, const char *lin
   // SubscribeLogsResponse - 29
   return this->send_buffer(buffer, 29);
 }
+bool APIConnection::send_compact_log_message(int level, uint32_t tag_key, const char *tag, uint32_t format_key,
+                                             const char *format, int line, const std::vector<uint8_t> &args) {
+  if (!this->send_log_string_(tag_key, tag) || !this->send_log_string_(format_key, format))
+    return false;
+
+  auto buffer = this->create_buffer();
+  // LogLevel level = 1;
+  buffer.encode_uint32(1, static_cast<uint32_t>(level));
+  // uint32 tag = 2;
+  buffer.encode_uint32(2, tag_key);
+  // uint32 format = 3;
+  buffer.encode_uint32(3, format_key);
+  // uint32 line = 4;
+  buffer.encode_uint32(4, static_cast<uint32_t>(line));
+  // bytes args = 5;
+  buffer.encode_bytes(5, args.data(), args.size());
+  // CompactLogResponse - 87
+  return this->send_buffer(buffer, 87);
+}
+bool APIConnection::send_log_string_(uint32_t key, const char *value) {
+  if (key < this->log_strings_sent_.size() && this->log_strings_sent_[key])
+    return true;
+
+  auto buffer = this->create_buffer();
+  // uint32 key = 1;
+  buffer.encode_uint32(1, key);
+  // string value = 2;
+  buffer.encode_string(2, value, strlen(value));
+  // LogStringResponse - 86
+  if (!this->send_buffer(buffer, 86))
+    return false;
+  if (key >= this->log_strings_sent_.size())
+    this->log_strings_sent_.resize(key + 1, false);
+  this->log_strings_sent_[key] = true;
+  return true;
+}
 
 HelloResponse APIConnection::hello(const HelloRequest &msg) {
   this->client_info_ = msg.client_info + " (" + this->helper_->getpeername() + ")";
@@ -901,7 +942,7 @@ HelloResponse APIConnection::hello(const HelloRequest &msg) {
 
   HelloResponse resp;
   resp.api_version_major = 1;
-  resp.api_version_minor = 7;
+  resp.api_version_minor = 9;
   resp.server_info = App.get_name() + " (esphome v" ESPHOME_VERSION ")";
   resp.name = App.get_name();
 
@@ -12,6 +12,10 @@
 namespace esphome {
 namespace api {
 
+/// SubscribeBluetoothLEAdvertisementsRequest flag, send advertisements undecoded and batched in
+/// BluetoothLERawAdvertisementsResponse messages.
+static const uint32_t BLUETOOTH_LE_SUBSCRIPTION_FLAG_RAW_ADVERTISEMENTS = 1 << 0;
+
 class APIConnection : public APIServerConnection {
  public:
   APIConnection(std::unique_ptr<socket::Socket> socket, APIServer *parent);
@@ -91,6 +95,9 @@ class APIConnection : public APIServerConnection {
   void media_player_command(const MediaPlayerCommandRequest &msg) override;
 #endif
   bool send_log_message(int level, const char *tag, const char *line);
+  /// Send a message as CompactLogResponse, preceded by the definitions of its tag and format string if needed.
+  bool send_compact_log_message(int level, uint32_t tag_key, const char *tag, uint32_t format_key, const char *format,
+                                int line, const std::vector<uint8_t> &args);
   void send_homeassistant_service_call(const HomeassistantServiceResponse &call) {
     if (!this->service_call_subscription_)
       return;
@@ -98,6 +105,11 @@ class APIConnection : public APIServerConnection {
   }
 #ifdef USE_BLUETOOTH_PROXY
   bool send_bluetooth_le_advertisement(const BluetoothLEAdvertisementResponse &msg);
+  bool send_bluetooth_le_raw_advertisements(const BluetoothLERawAdvertisementsResponse &msg);
+  /// Whether this client is subscribed to advertisements in the given format.
+  bool is_bluetooth_le_advertisement_subscribed(bool raw) const {
+    return this->bluetooth_le_advertisement_subscription_ && this->bluetooth_le_raw_advertisements_ == raw;
+  }
 
   void bluetooth_device_request(const BluetoothDeviceRequest &msg) override;
   void bluetooth_gatt_read(const BluetoothGATTReadRequest &msg) override;
@@ -138,6 +150,9 @@ class APIConnection : public APIServerConnection {
   }
   void subscribe_logs(const SubscribeLogsRequest &msg) override {
     this->log_subscription_ = msg.level;
+    this->log_compact_ = msg.compact;
+    // the client may have dropped the strings it received on an earlier subscription
+    this->log_strings_sent_.clear();
     if (msg.dump_config)
       App.schedule_dump_config();
   }
@@ -152,6 +167,7 @@ class APIConnection : public APIServerConnection {
   void execute_service(const ExecuteServiceRequest &msg) override;
   void subscribe_bluetooth_le_advertisements(const SubscribeBluetoothLEAdvertisementsRequest &msg) override {
     this->bluetooth_le_advertisement_subscription_ = true;
+    this->bluetooth_le_raw_advertisements_ = (msg.flags & BLUETOOTH_LE_SUBSCRIPTION_FLAG_RAW_ADVERTISEMENTS) != 0;
   }
   bool is_authenticated() override { return this->connection_state_ == ConnectionState::AUTHENTICATED; }
   bool is_connection_setup() override {
@@ -171,6 +187,7 @@ class APIConnection : public APIServerConnection {
   friend APIServer;
 
   bool send_(const void *buf, size_t len, bool force);
+  bool send_log_string_(uint32_t key, const char *value);
 
   enum class ConnectionState {
     WAITING_FOR_HELLO,
@@ -194,10 +211,14 @@ class APIConnection : public APIServerConnection {
 
   bool state_subscription_{false};
   int log_subscription_{ESPHOME_LOG_LEVEL_NONE};
+  bool log_compact_{false};
+  /// Indexed by key, whether the LogStringResponse for it was sent on this connection.
+  std::vector<bool> log_strings_sent_;
   uint32_t last_traffic_;
   bool sent_ping_{false};
   bool service_call_subscription_{false};
   bool bluetooth_le_advertisement_subscription_{false};
+  bool bluetooth_le_raw_advertisements_{false};
   bool next_close_ = false;
   APIServer *parent_;
   InitialStateIterator initial_state_iterator_;
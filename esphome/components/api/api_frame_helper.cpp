@@ -264,6 +264,47 @@ APIError APINoiseFrameHelper::try_read_frame_(ParsedFrame *frame) {
   return APIError::OK;
 }
 
+/** Find a complete frame in the first segment of the socket's receive buffer, so it can be decrypted in place.
+ *
+ * @return false if the socket can't expose its receive buffer, a frame was already partially read or the next frame
+ *   is split over several segments. The caller then reads it with try_read_frame_().
+ */
+bool APINoiseFrameHelper::try_peek_frame_(ParsedFrame *frame) {
+  if (rx_header_buf_len_ != 0 || rx_buf_len_ != 0)
+    return false;
+  struct iovec segment;
+  if (socket_->peek(&segment, 1) != 1)
+    return false;
+
+  uint8_t *data = reinterpret_cast<uint8_t *>(segment.iov_base);
+  // leave bad indicators to try_read_frame_(), which reports them
+  if (segment.iov_len < 3 || data[0] != 0x01)
+    return false;
+  uint16_t msg_size = (((uint16_t) data[1]) << 8) | data[2];
+  if (segment.iov_len - 3 < msg_size)
+    return false;
+
+#ifdef HELPER_LOG_PACKETS
+  ESP_LOGVV(TAG, "Received frame: %s", format_hex_pretty(data + 3, msg_size).c_str());
+#endif
+  frame->data = data + 3;
+  frame->len = msg_size;
+  rx_peeked_len_ = 3 + msg_size;
+  return true;
+}
+APIError APINoiseFrameHelper::release_peeked_frame_() {
+  if (rx_peeked_len_ == 0)
+    return APIError::OK;
+  int err = socket_->consume(rx_peeked_len_);
+  rx_peeked_len_ = 0;
+  if (err != 0) {
+    state_ = State::FAILED;
+    HELPER_LOG("Socket consume failed with errno %d", errno);
+    return APIError::SOCKET_READ_FAILED;
+  }
+  return APIError::OK;
+}
+
 /** To be called from read/write methods.
  *
  * This method runs through the internal handshake methods, if in that state.
@@ -416,6 +457,10 @@ void APINoiseFrameHelper::send_explicit_handshake_reject_(const std::string &rea
 APIError APINoiseFrameHelper::read_packet(ReadPacketBuffer *buffer) {
   int err;
   APIError aerr;
+  aerr = release_peeked_frame_();
+  if (aerr != APIError::OK) {
+    return aerr;
+  }
   aerr = state_action_();
   if (aerr != APIError::OK) {
     return aerr;
@@ -426,13 +471,17 @@ APIError APINoiseFrameHelper::read_packet(ReadPacketBuffer *buffer) {
   }
 
   ParsedFrame frame;
-  aerr = try_read_frame_(&frame);
-  if (aerr != APIError::OK)
-    return aerr;
+  if (!try_peek_frame_(&frame)) {
+    aerr = try_read_frame_(&frame);
+    if (aerr != APIError::OK)
+      return aerr;
+    frame.data = frame.msg.data();
+    frame.len = frame.msg.size();
+  }
 
   NoiseBuffer mbuf;
   noise_buffer_init(mbuf);
-  noise_buffer_set_inout(mbuf, frame.msg.data(), frame.msg.size(), frame.msg.size());
+  noise_buffer_set_inout(mbuf, frame.data, frame.len, frame.len);
   err = noise_cipherstate_decrypt(recv_cipher_, &mbuf);
   if (err != 0) {
     state_ = State::FAILED;
@@ -441,7 +490,7 @@ APIError APINoiseFrameHelper::read_packet(ReadPacketBuffer *buffer) {
   }
 
   size_t msg_size = mbuf.size;
-  uint8_t *msg_data = frame.msg.data();
+  uint8_t *msg_data = frame.data;
   if (msg_size < 4) {
     state_ = State::FAILED;
     HELPER_LOG("Bad data packet: size %d too short", msg_size);
@@ -461,7 +510,7 @@ APIError APINoiseFrameHelper::read_packet(ReadPacketBuffer *buffer) {
   }
 
   buffer->container = std::move(frame.msg);
-  buffer->data_offset = 4;
+  buffer->data = msg_data + 4;
   buffer->data_len = data_len;
   buffer->type = type;
   return APIError::OK;
@@ -884,20 +933,82 @@ APIError APIPlaintextFrameHelper::try_read_frame_(ParsedFrame *frame) {
   return APIError::OK;
 }
 
+/** Find a complete frame in the first segment of the socket's receive buffer, so it can be parsed in place.
+ *
+ * @return false if the socket can't expose its receive buffer, a frame was already partially read or the next frame
+ *   is split over several segments. The caller then reads it with try_read_frame_().
+ */
+bool APIPlaintextFrameHelper::try_peek_frame_(ParsedFrame *frame) {
+  if (rx_header_parsed_ || !rx_header_buf_.empty())
+    return false;
+  struct iovec segment;
+  if (socket_->peek(&segment, 1) != 1)
+    return false;
+
+  uint8_t *data = reinterpret_cast<uint8_t *>(segment.iov_base);
+  size_t len = segment.iov_len;
+  // leave bad indicators to try_read_frame_(), which reports them
+  if (len < 3 || data[0] != 0x00)
+    return false;
+
+  size_t i = 1;
+  uint32_t consumed = 0;
+  auto msg_size_varint = ProtoVarInt::parse(&data[i], len - i, &consumed);
+  if (!msg_size_varint.has_value())
+    return false;
+  i += consumed;
+  auto msg_type_varint = ProtoVarInt::parse(&data[i], len - i, &consumed);
+  if (!msg_type_varint.has_value())
+    return false;
+  i += consumed;
+  uint32_t msg_size = msg_size_varint->as_uint32();
+  if (len - i < msg_size)
+    return false;
+
+#ifdef HELPER_LOG_PACKETS
+  ESP_LOGVV(TAG, "Received frame: %s", format_hex_pretty(data + i, msg_size).c_str());
+#endif
+  rx_header_parsed_len_ = msg_size;
+  rx_header_parsed_type_ = msg_type_varint->as_uint32();
+  frame->data = data + i;
+  frame->len = msg_size;
+  rx_peeked_len_ = i + msg_size;
+  return true;
+}
+APIError APIPlaintextFrameHelper::release_peeked_frame_() {
+  if (rx_peeked_len_ == 0)
+    return APIError::OK;
+  int err = socket_->consume(rx_peeked_len_);
+  rx_peeked_len_ = 0;
+  if (err != 0) {
+    state_ = State::FAILED;
+    HELPER_LOG("Socket consume failed with errno %d", errno);
+    return APIError::SOCKET_READ_FAILED;
+  }
+  return APIError::OK;
+}
+
 APIError APIPlaintextFrameHelper::read_packet(ReadPacketBuffer *buffer) {
   APIError aerr;
+  aerr = release_peeked_frame_();
+  if (aerr != APIError::OK)
+    return aerr;
 
   if (state_ != State::DATA) {
     return APIError::WOULD_BLOCK;
   }
 
   ParsedFrame frame;
-  aerr = try_read_frame_(&frame);
-  if (aerr != APIError::OK)
-    return aerr;
+  if (!try_peek_frame_(&frame)) {
+    aerr = try_read_frame_(&frame);
+    if (aerr != APIError::OK)
+      return aerr;
+    frame.data = frame.msg.data();
+    frame.len = frame.msg.size();
+  }
 
   buffer->container = std::move(frame.msg);
-  buffer->data_offset = 0;
+  buffer->data = frame.data;
   buffer->data_len = rx_header_parsed_len_;
   buffer->type = rx_header_parsed_type_;
   return APIError::OK;
@@ -17,9 +17,11 @@ namespace esphome {
 namespace api {
 
 struct ReadPacketBuffer {
+  /// Owns the packet if it was copied out of the socket, empty if it is read in place.
   std::vector<uint8_t> container;
   uint16_t type;
-  size_t data_offset;
+  /// The packet payload, valid until the next read_packet() call.
+  uint8_t *data;
   size_t data_len;
 };
 
@@ -93,10 +95,17 @@ class APINoiseFrameHelper : public APIFrameHelper {
  protected:
   struct ParsedFrame {
     std::vector<uint8_t> msg;
+    /// Set if the frame is read in place from the socket's receive buffer instead of copied into msg.
+    uint8_t *data{nullptr};
+    size_t len{0};
   };
 
   APIError state_action_();
   APIError try_read_frame_(ParsedFrame *frame);
+  /// Find a complete frame in the first segment of the socket's receive buffer, returns false to fall back to copying.
+  bool try_peek_frame_(ParsedFrame *frame);
+  /// Consume the frame that was handed out in place by the previous read_packet().
+  APIError release_peeked_frame_();
   APIError try_send_tx_buf_();
   APIError write_frame_(const uint8_t *data, size_t len);
   APIError write_raw_(const struct iovec *iov, int iovcnt);
@@ -111,6 +120,8 @@ class APINoiseFrameHelper : public APIFrameHelper {
   size_t rx_header_buf_len_ = 0;
   std::vector<uint8_t> rx_buf_;
   size_t rx_buf_len_ = 0;
+  /// Length of the frame that was handed out in place and still has to be consumed from the socket.
+  size_t rx_peeked_len_ = 0;
 
   std::vector<uint8_t> tx_buf_;
   std::vector<uint8_t> prologue_;
@@ -153,9 +164,16 @@ class APIPlaintextFrameHelper : public APIFrameHelper {
  protected:
   struct ParsedFrame {
     std::vector<uint8_t> msg;
+    /// Set if the frame is read in place from the socket's receive buffer instead of copied into msg.
+    uint8_t *data{nullptr};
+    size_t len{0};
   };
 
   APIError try_read_frame_(ParsedFrame *frame);
+  /// Find a complete frame in the first segment of the socket's receive buffer, returns false to fall back to copying.
+  bool try_peek_frame_(ParsedFrame *frame);
+  /// Consume the frame that was handed out in place by the previous read_packet().
+  APIError release_peeked_frame_();
   APIError try_send_tx_buf_();
   APIError write_raw_(const struct iovec *iov, int iovcnt);
 
@@ -169,6 +187,8 @@ class APIPlaintextFrameHelper : public APIFrameHelper {
 
   std::vector<uint8_t> rx_buf_;
   size_t rx_buf_len_ = 0;
+  /// Length of the frame that was handed out in place and still has to be consumed from the socket.
+  size_t rx_peeked_len_ = 0;
 
   std::vector<uint8_t> tx_buf_;
 
@@ -1,5 +1,6 @@
 #include "api_server.h"
 #include "api_connection.h"
+#include "compact_log.h"
 #include "esphome/core/application.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/log.h"
@@ -11,6 +12,9 @@
 
 #ifdef USE_LOGGER
 #include "esphome/components/logger/logger.h"
+#ifdef USE_ESP32
+#include <soc/soc_memory_layout.h>
+#endif
 #endif
 
 #include <algorithm>
@@ -68,12 +72,8 @@ void APIServer::setup() {
 
 #ifdef USE_LOGGER
   if (logger::global_logger != nullptr) {
-    logger::global_logger->add_on_log_callback([this](int level, const char *tag, const char *message) {
-      for (auto &c : this->clients_) {
-        if (!c->remove_)
-          c->send_log_message(level, tag, message);
-      }
-    });
+    logger::global_logger->add_on_log_callback(
+        [this](int level, const char *tag, const char *message) { this->on_log_message_(level, tag, message); });
   }
 #endif
 
@@ -297,6 +297,18 @@ void APIServer::send_bluetooth_le_advertisement(const BluetoothLEAdvertisementRe
     client->send_bluetooth_le_advertisement(call);
   }
 }
+void APIServer::send_bluetooth_le_raw_advertisements(const BluetoothLERawAdvertisementsResponse &call) {
+  for (auto &client : this->clients_) {
+    client->send_bluetooth_le_raw_advertisements(call);
+  }
+}
+bool APIServer::has_bluetooth_le_advertisement_subscription(bool raw) const {
+  for (const auto &client : this->clients_) {
+    if (client->is_bluetooth_le_advertisement_subscribed(raw))
+      return true;
+  }
+  return false;
+}
 void APIServer::send_bluetooth_device_connection(uint64_t address, bool connected, uint16_t mtu, esp_err_t error) {
   BluetoothDeviceConnectionResponse call;
   call.address = address;
@@ -394,5 +406,69 @@ void APIServer::on_shutdown() {
   delay(10);
 }
 
+#ifdef USE_LOGGER
+/// Upper bound of distinct tags and format strings sent in compact form, later ones are sent formatted.
+static const uint32_t MAX_LOG_STRINGS = 512;
+
+#ifdef USE_ESP8266
+extern "C" char _rodata_start, _rodata_end;  // NOLINT(bugprone-reserved-identifier,readability-identifier-naming)
+#endif
+
+/// Whether a string is a literal in flash or read-only data, strings anywhere else may be built at runtime and
+/// would fill up the string table.
+static bool is_static_string(const char *str) {
+#if defined(USE_ESP32)
+  return esp_ptr_in_drom(str);
+#elif defined(USE_ESP8266)
+  // format strings are stored in flash by the log macros, tags are in read-only data in RAM
+  return reinterpret_cast<uintptr_t>(str) >= 0x40200000 || (str >= &_rodata_start && str < &_rodata_end);
+#elif defined(USE_RP2040)
+  // the flash is mapped from XIP_BASE
+  return reinterpret_cast<uintptr_t>(str) >= 0x10000000 && reinterpret_cast<uintptr_t>(str) < 0x11000000;
+#else
+  return false;
+#endif
+}
+
+void APIServer::on_log_message_(int level, const char *tag, const char *message) {
+  const logger::LogFormat *format = logger::global_logger->get_current_format();
+  bool compact = format != nullptr;
+  bool encoded = false;
+  uint32_t tag_key = 0;
+  uint32_t format_key = 0;
+  for (auto &c : this->clients_) {
+    if (c->remove_)
+      continue;
+    if (compact && c->log_compact_ && c->log_subscription_ >= level) {
+      if (!encoded) {
+        encoded = true;
+        tag_key = this->get_log_string_key_(tag);
+        format_key = this->get_log_string_key_(format->format);
+        this->log_args_.clear();
+        va_list args;
+        va_copy(args, *format->args);
+        compact = tag_key != 0 && format_key != 0 && encode_log_args(this->log_args_, format->format, args);
+        va_end(args);
+      }
+      if (compact) {
+        c->send_compact_log_message(level, tag_key, tag, format_key, format->format, format->line, this->log_args_);
+        continue;
+      }
+    }
+    c->send_log_message(level, tag, message);
+  }
+}
+uint32_t APIServer::get_log_string_key_(const char *str) {
+  auto it = this->log_strings_.find(str);
+  if (it != this->log_strings_.end())
+    return it->second;
+  if (this->next_log_string_key_ > MAX_LOG_STRINGS || !is_static_string(str))
+    return 0;
+  const uint32_t key = this->next_log_string_key_++;
+  this->log_strings_[str] = key;
+  return key;
+}
+#endif
+
 }  // namespace api
 }  // namespace esphome
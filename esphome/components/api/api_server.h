@@ -12,6 +12,7 @@
 #include "user_services.h"
 #include "api_noise_context.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace esphome {
@@ -77,6 +78,9 @@ class APIServer : public Component, public Controller {
   void send_homeassistant_service_call(const HomeassistantServiceResponse &call);
 #ifdef USE_BLUETOOTH_PROXY
   void send_bluetooth_le_advertisement(const BluetoothLEAdvertisementResponse &call);
+  void send_bluetooth_le_raw_advertisements(const BluetoothLERawAdvertisementsResponse &call);
+  /// Whether any client is subscribed to advertisements in the given format.
+  bool has_bluetooth_le_advertisement_subscription(bool raw) const;
   void send_bluetooth_device_connection(uint64_t address, bool connected, uint16_t mtu = 0, esp_err_t error = ESP_OK);
   void send_bluetooth_connections_free(uint8_t free, uint8_t limit);
   void send_bluetooth_gatt_read_response(const BluetoothGATTReadResponse &call);
@@ -106,6 +110,17 @@ class APIServer : public Component, public Controller {
   const std::vector<UserServiceDescriptor *> &get_user_services() const { return this->user_services_; }
 
  protected:
+#ifdef USE_LOGGER
+  void on_log_message_(int level, const char *tag, const char *message);
+  /// The key of a tag or format string in the compact log string table, 0 if the table is full or the string is not
+  /// a literal, in which case the message is sent formatted.
+  uint32_t get_log_string_key_(const char *str);
+
+  std::unordered_map<const char *, uint32_t> log_strings_;
+  uint32_t next_log_string_key_{1};
+  /// Arguments of the current message in compact form, encoded once for all clients.
+  std::vector<uint8_t> log_args_;
+#endif
   std::unique_ptr<socket::Socket> socket_ = nullptr;
   uint16_t port_{6053};
   uint32_t reboot_timeout_{300000};
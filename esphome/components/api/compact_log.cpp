@@ -0,0 +1,198 @@
+#include "compact_log.h"
+#include "proto.h"
+
+#include <cstring>
+#include <cstddef>
+
+namespace esphome {
+namespace api {
+
+enum LengthModifier {
+  LENGTH_NONE = 0,
+  LENGTH_HH,
+  LENGTH_H,
+  LENGTH_L,
+  LENGTH_LL,
+  LENGTH_J,
+  LENGTH_Z,
+  LENGTH_T,
+  LENGTH_LONG_DOUBLE,
+};
+
+static void encode_signed(std::vector<uint8_t> &out, int64_t value) {
+  ProtoVarInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)).encode(out);
+}
+static void encode_unsigned(std::vector<uint8_t> &out, uint64_t value) { ProtoVarInt(value).encode(out); }
+static void encode_double(std::vector<uint8_t> &out, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; i++)
+    out.push_back(bits >> (i * 8));
+}
+static void encode_string(std::vector<uint8_t> &out, const char *value, int precision) {
+  if (value == nullptr)
+    value = "(null)";
+  const size_t len = precision < 0 ? strlen(value) : strnlen(value, precision);
+  encode_unsigned(out, len);
+  out.insert(out.end(), value, value + len);
+}
+
+static bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+bool encode_log_args(std::vector<uint8_t> &out, const char *format, va_list args) {
+  for (const char *p = format; *p != '\0'; p++) {
+    if (*p != '%')
+      continue;
+    p++;
+    if (*p == '%')
+      continue;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+      p++;
+    if (*p == '*') {
+      encode_signed(out, va_arg(args, int));
+      p++;
+    } else {
+      while (is_digit(*p))
+        p++;
+    }
+    int precision = -1;
+    if (*p == '.') {
+      p++;
+      if (*p == '*') {
+        precision = va_arg(args, int);
+        encode_signed(out, precision);
+        p++;
+      } else {
+        precision = 0;
+        while (is_digit(*p))
+          precision = precision * 10 + (*p++ - '0');
+      }
+    }
+
+    LengthModifier length = LENGTH_NONE;
+    switch (*p) {
+      case 'h':
+        length = p[1] == 'h' ? LENGTH_HH : LENGTH_H;
+        p += length == LENGTH_HH ? 2 : 1;
+        break;
+      case 'l':
+        length = p[1] == 'l' ? LENGTH_LL : LENGTH_L;
+        p += length == LENGTH_LL ? 2 : 1;
+        break;
+      case 'j':
+        length = LENGTH_J;
+        p++;
+        break;
+      case 'z':
+        length = LENGTH_Z;
+        p++;
+        break;
+      case 't':
+        length = LENGTH_T;
+        p++;
+        break;
+      case 'L':
+        length = LENGTH_LONG_DOUBLE;
+        p++;
+        break;
+      default:
+        break;
+    }
+
+    if (length == LENGTH_L && (*p == 'c' || *p == 's'))
+      return false;
+    switch (*p) {
+      case 'd':
+      case 'i': {
+        int64_t value;
+        switch (length) {
+          case LENGTH_HH:
+            value = static_cast<signed char>(va_arg(args, int));
+            break;
+          case LENGTH_H:
+            value = static_cast<short>(va_arg(args, int));
+            break;
+          case LENGTH_L:
+            value = va_arg(args, long);
+            break;
+          case LENGTH_LL:
+            value = va_arg(args, long long);
+            break;
+          case LENGTH_J:
+            value = va_arg(args, intmax_t);
+            break;
+          case LENGTH_Z:
+          case LENGTH_T:
+            value = va_arg(args, ptrdiff_t);
+            break;
+          default:
+            value = va_arg(args, int);
+            break;
+        }
+        encode_signed(out, value);
+        break;
+      }
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+      case 'c': {
+        uint64_t value;
+        switch (length) {
+          case LENGTH_HH:
+            value = static_cast<unsigned char>(va_arg(args, unsigned int));
+            break;
+          case LENGTH_H:
+            value = static_cast<unsigned short>(va_arg(args, unsigned int));
+            break;
+          case LENGTH_L:
+            value = va_arg(args, unsigned long);
+            break;
+          case LENGTH_LL:
+            value = va_arg(args, unsigned long long);
+            break;
+          case LENGTH_J:
+            value = va_arg(args, uintmax_t);
+            break;
+          case LENGTH_Z:
+          case LENGTH_T:
+            value = va_arg(args, size_t);
+            break;
+          default:
+            value = va_arg(args, unsigned int);
+            break;
+        }
+        encode_unsigned(out, value);
+        break;
+      }
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        if (length == LENGTH_LONG_DOUBLE) {
+          encode_double(out, va_arg(args, long double));
+        } else {
+          encode_double(out, va_arg(args, double));
+        }
+        break;
+      case 's':
+        encode_string(out, va_arg(args, const char *), precision);
+        break;
+      case 'p':
+        encode_unsigned(out, reinterpret_cast<uintptr_t>(va_arg(args, void *)));
+        break;
+      default:
+        // %n, or a truncated conversion at the end of the string
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace api
+}  // namespace esphome
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace api {
+
+/** Append the arguments of a printf-style log call to out, encoded as in CompactLogResponse.args.
+ *
+ * Walks the conversions of format to know the type of each argument. Returns false if format contains a conversion
+ * the client could not reproduce (like %n), in which case the message has to be sent formatted.
+ */
+bool encode_log_args(std::vector<uint8_t> &out, const char *format, va_list args);
+
+}  // namespace api
+}  // namespace esphome
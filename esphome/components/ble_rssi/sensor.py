@@ -55,7 +55,14 @@ CONFIG_SCHEMA = cv.All(
 async def to_code(config):
     var = await sensor.new_sensor(config)
     await cg.register_component(var, config)
-    await esp32_ble_tracker.register_ble_device(var, config)
+    service_uuid = config.get(CONF_SERVICE_UUID, "")
+    await esp32_ble_tracker.register_ble_device(
+        var,
+        config,
+        service_uuid=int(service_uuid, 16)
+        if len(service_uuid) == len(esp32_ble_tracker.bt_uuid16_format)
+        else None,
+    )
 
     if CONF_MAC_ADDRESS in config:
         cg.add(var.set_address(config[CONF_MAC_ADDRESS].as_hex))
@@ -1,5 +1,6 @@
 #include "bluetooth_proxy.h"
 
+#include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
 #ifdef USE_ESP32
@@ -11,6 +12,10 @@ namespace bluetooth_proxy {
 
 static const char *const TAG = "bluetooth_proxy";
 static const int DONE_SENDING_SERVICES = -2;
+/// Raw advertisements are sent in batches of up to this many...
+static const size_t RAW_ADVERTISEMENTS_BATCH_SIZE = 16;
+/// ... or after this long, whichever comes first.
+static const uint32_t RAW_ADVERTISEMENTS_FLUSH_INTERVAL_MS = 100;
 
 std::vector<uint64_t> get_128bit_uuid_vec(esp_bt_uuid_t uuid_source) {
   esp_bt_uuid_t uuid = espbt::ESPBTUUID::from_uuid(uuid_source).as_128bit().get_uuid();
@@ -31,11 +36,40 @@ bool BluetoothProxy::parse_device(const esp32_ble_tracker::ESPBTDevice &device)
     return false;
   ESP_LOGV(TAG, "Proxying packet from %s - %s. RSSI: %d dB", device.get_name().c_str(), device.address_str().c_str(),
            device.get_rssi());
-  this->send_api_packet_(device);
+  // clients that subscribed to raw advertisements decode them themselves, so only decode for the others
+  if (api::global_api_server->has_bluetooth_le_advertisement_subscription(true))
+    this->queue_raw_advertisement_(device);
+  if (api::global_api_server->has_bluetooth_le_advertisement_subscription(false))
+    this->send_api_packet_(device);
 
   return true;
 }
 
+void BluetoothProxy::queue_raw_advertisement_(const esp32_ble_tracker::ESPBTDevice &device) {
+  auto &advertisements = this->raw_advertisements_.advertisements;
+  if (advertisements.empty()) {
+    advertisements.reserve(RAW_ADVERTISEMENTS_BATCH_SIZE);
+    this->raw_advertisements_started_ = millis();
+  }
+  advertisements.emplace_back();
+  auto &advertisement = advertisements.back();
+  advertisement.address = device.address_uint64();
+  advertisement.rssi = device.get_rssi();
+  advertisement.address_type = device.get_address_type();
+  auto adv_data = device.get_adv_data();
+  advertisement.data.assign(reinterpret_cast<const char *>(adv_data.data()), adv_data.size());
+
+  if (advertisements.size() >= RAW_ADVERTISEMENTS_BATCH_SIZE)
+    this->flush_raw_advertisements_();
+}
+
+void BluetoothProxy::flush_raw_advertisements_() {
+  if (this->raw_advertisements_.advertisements.empty())
+    return;
+  api::global_api_server->send_bluetooth_le_raw_advertisements(this->raw_advertisements_);
+  this->raw_advertisements_.advertisements.clear();
+}
+
 void BluetoothProxy::send_api_packet_(const esp32_ble_tracker::ESPBTDevice &device) {
   api::BluetoothLEAdvertisementResponse resp;
   resp.address = device.address_uint64();
@@ -87,8 +121,12 @@ void BluetoothProxy::loop() {
         connection->disconnect();
       }
     }
+    this->raw_advertisements_.advertisements.clear();
     return;
   }
+  if (!this->raw_advertisements_.advertisements.empty() &&
+      millis() - this->raw_advertisements_started_ >= RAW_ADVERTISEMENTS_FLUSH_INTERVAL_MS)
+    this->flush_raw_advertisements_();
   for (auto *connection : this->connections_) {
     if (connection->send_service_ == connection->service_count_) {
       connection->send_service_ = DONE_SENDING_SERVICES;
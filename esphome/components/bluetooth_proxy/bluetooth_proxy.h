@@ -49,12 +49,18 @@ class BluetoothProxy : public esp32_ble_tracker::ESPBTDeviceListener, public Com
 
  protected:
   void send_api_packet_(const esp32_ble_tracker::ESPBTDevice &device);
+  /// Add the undecoded advertisement to the current batch, sending the batch once it is full.
+  void queue_raw_advertisement_(const esp32_ble_tracker::ESPBTDevice &device);
+  void flush_raw_advertisements_();
 
   BluetoothConnection *get_connection_(uint64_t address, bool reserve);
 
   bool active_;
 
   std::vector<BluetoothConnection *> connections_{};
+  api::BluetoothLERawAdvertisementsResponse raw_advertisements_{};
+  /// When the first advertisement of the current batch was queued.
+  uint32_t raw_advertisements_started_{0};
 };
 
 extern BluetoothProxy *global_bluetooth_proxy;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
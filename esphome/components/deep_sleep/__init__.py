@@ -150,6 +150,8 @@ CONF_DEFAULT = "default"
 CONF_GPIO_WAKEUP_REASON = "gpio_wakeup_reason"
 CONF_TOUCH_WAKEUP_REASON = "touch_wakeup_reason"
 CONF_UNTIL = "until"
+CONF_PROFILE = "profile"
+CONF_TIMER_WAKEUP_SKIP = "timer_wakeup_skip"
 
 WAKEUP_CAUSES_SCHEMA = cv.Schema(
     {
@@ -185,6 +187,8 @@ CONFIG_SCHEMA = cv.Schema(
             ),
         ),
         cv.Optional(CONF_TOUCH_WAKEUP): cv.All(cv.only_on_esp32, cv.boolean),
+        cv.Optional(CONF_PROFILE, default=False): cv.boolean,
+        cv.Optional(CONF_TIMER_WAKEUP_SKIP): cv.ensure_list(cv.use_id(cg.Component)),
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
@@ -237,6 +241,12 @@ async def to_code(config):
     if CONF_TOUCH_WAKEUP in config:
         cg.add(var.set_touch_wakeup(config[CONF_TOUCH_WAKEUP]))
 
+    for component_id in config.get(CONF_TIMER_WAKEUP_SKIP, []):
+        component = await cg.get_variable(component_id)
+        cg.add(var.add_timer_wakeup_skip(component))
+
+    if config[CONF_PROFILE]:
+        cg.add_define("USE_DEEP_SLEEP_PROFILE")
     cg.add_define("USE_DEEP_SLEEP")
 
 
@@ -5,6 +5,16 @@
 
 #ifdef USE_ESP8266
 #include <Esp.h>
+#include <user_interface.h>
+#endif
+#if defined(USE_DEEP_SLEEP_PROFILE) && defined(USE_ESP32)
+#include <esp_attr.h>
+#endif
+#if defined(USE_DEEP_SLEEP_PROFILE) && (defined(USE_WIFI) || defined(USE_ETHERNET))
+#include "esphome/components/network/util.h"
+#endif
+#if defined(USE_DEEP_SLEEP_PROFILE) && defined(USE_API)
+#include "esphome/components/api/api_server.h"
 #endif
 
 namespace esphome {
@@ -14,6 +24,29 @@ static const char *const TAG = "deep_sleep";
 
 bool global_has_deep_sleep = false;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
+#ifdef USE_DEEP_SLEEP_PROFILE
+static WakeProfile s_profile{};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+#ifdef USE_ESP32
+// RTC slow memory keeps its contents in deep sleep, on the ESP8266 the RTC preferences are used instead
+static RTC_NOINIT_ATTR WakeProfile s_previous_profile;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+void record_setup_duration(Component *component, uint32_t duration_ms) {
+  // keep the slowest ones, sorted by duration
+  uint8_t i = WAKE_PROFILE_COMPONENTS;
+  while (i > 0 && (s_profile.component_sources[i - 1] == nullptr || s_profile.component_setup_ms[i - 1] < duration_ms))
+    i--;
+  if (i == WAKE_PROFILE_COMPONENTS)
+    return;
+  for (uint8_t j = WAKE_PROFILE_COMPONENTS - 1; j > i; j--) {
+    s_profile.component_sources[j] = s_profile.component_sources[j - 1];
+    s_profile.component_setup_ms[j] = s_profile.component_setup_ms[j - 1];
+  }
+  s_profile.component_sources[i] = component->get_component_source();
+  s_profile.component_setup_ms[i] = duration_ms;
+}
+#endif
+
 optional<uint32_t> DeepSleepComponent::get_run_duration_() const {
 #ifdef USE_ESP32
   if (this->wakeup_cause_to_run_duration_.has_value()) {
@@ -33,9 +66,31 @@ optional<uint32_t> DeepSleepComponent::get_run_duration_() const {
   return this->run_duration_;
 }
 
+bool DeepSleepComponent::woke_up_by_timer_() const {
+#ifdef USE_ESP32
+  return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+#elif defined(USE_ESP8266)
+  // the timer wakes the ESP8266 through its reset pin, so this is any wakeup from deep sleep
+  return ESP.getResetInfoPtr()->reason == REASON_DEEP_SLEEP_AWAKE;  // NOLINT
+#else
+  return false;
+#endif
+}
+
+void DeepSleepComponent::add_timer_wakeup_skip(Component *component) {
+  if (this->woke_up_by_timer_())
+    component->skip_setup();
+}
+
 void DeepSleepComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up Deep Sleep...");
   global_has_deep_sleep = true;
+#ifdef USE_DEEP_SLEEP_PROFILE
+  s_profile.firmware_hash = fnv1_hash(App.get_compilation_time());
+#ifdef USE_ESP8266
+  this->profile_pref_ = global_preferences->make_preference<WakeProfile>(s_profile.firmware_hash, false);
+#endif
+#endif
 
   const optional<uint32_t> run_duration = get_run_duration_();
   if (run_duration.has_value()) {
@@ -66,9 +121,60 @@ void DeepSleepComponent::dump_config() {
 #endif
 }
 void DeepSleepComponent::loop() {
+#ifdef USE_DEEP_SLEEP_PROFILE
+  this->update_profile_();
+#endif
   if (this->next_enter_deep_sleep_)
     this->begin_sleep();
 }
+
+#ifdef USE_DEEP_SLEEP_PROFILE
+void DeepSleepComponent::update_profile_() {
+  const uint32_t now = millis();
+  if (s_profile.setup_ms == 0)
+    s_profile.setup_ms = now;
+  bool connected = true;
+#if defined(USE_WIFI) || defined(USE_ETHERNET)
+  if (s_profile.wifi_connected_ms == 0 && network::is_connected())
+    s_profile.wifi_connected_ms = now;
+  connected = s_profile.wifi_connected_ms != 0;
+#endif
+#ifdef USE_API
+  if (s_profile.api_connected_ms == 0 && api::global_api_server != nullptr && api::global_api_server->is_connected())
+    s_profile.api_connected_ms = now;
+  // the API state alone would hide a network connection, e.g. when only MQTT or the serial log is used
+  connected = connected || s_profile.api_connected_ms != 0;
+#endif
+  if (!connected || this->profile_reported_)
+    return;
+  this->profile_reported_ = true;
+
+  // report the previous wake, this one only ends when going to sleep
+  WakeProfile previous{};
+#ifdef USE_ESP32
+  previous = s_previous_profile;
+#elif defined(USE_ESP8266)
+  if (!this->profile_pref_.load(&previous))
+    return;
+#endif
+  if (previous.firmware_hash != s_profile.firmware_hash || previous.awake_ms == 0)
+    return;
+  ESP_LOGI(TAG, "Previous wake: awake %u ms, setup %u ms, network %u ms, API %u ms", previous.awake_ms,
+           previous.setup_ms, previous.wifi_connected_ms, previous.api_connected_ms);
+  for (uint8_t i = 0; i < WAKE_PROFILE_COMPONENTS && previous.component_sources[i] != nullptr; i++) {
+    ESP_LOGI(TAG, "  Setup of %s: %u ms", previous.component_sources[i], previous.component_setup_ms[i]);
+  }
+}
+
+void DeepSleepComponent::save_profile_() {
+  s_profile.awake_ms = millis();
+#ifdef USE_ESP32
+  s_previous_profile = s_profile;
+#elif defined(USE_ESP8266)
+  this->profile_pref_.save(&s_profile);
+#endif
+}
+#endif
 float DeepSleepComponent::get_loop_priority() const {
   return -100.0f;  // run after everything else is ready
 }
@@ -117,6 +223,9 @@ void DeepSleepComponent::begin_sleep(bool manual) {
   if (this->sleep_duration_.has_value()) {
     ESP_LOGI(TAG, "Sleeping for %" PRId64 "us", *this->sleep_duration_);
   }
+#ifdef USE_DEEP_SLEEP_PROFILE
+  this->save_profile_();
+#endif
   App.run_safe_shutdown_hooks();
 
 #if defined(USE_ESP32)
@@ -4,6 +4,9 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/automation.h"
 #include "esphome/core/hal.h"
+#ifdef USE_DEEP_SLEEP_PROFILE
+#include "esphome/core/preferences.h"
+#endif
 
 #ifdef USE_ESP32
 #include <esp_sleep.h>
@@ -47,6 +50,26 @@ struct WakeupCauseToRunDuration {
 
 #endif
 
+#ifdef USE_DEEP_SLEEP_PROFILE
+/// Number of the slowest component setups that are kept in the profile.
+static const uint8_t WAKE_PROFILE_COMPONENTS = 6;
+
+/// Where the time of a wake cycle went, kept in RTC memory to be reported on the next wake.
+struct WakeProfile {
+  /// Hash of the firmware it was recorded with, the component names point into that firmware.
+  uint32_t firmware_hash;
+  uint32_t setup_ms;
+  uint32_t wifi_connected_ms;
+  uint32_t api_connected_ms;
+  uint32_t awake_ms;
+  const char *component_sources[WAKE_PROFILE_COMPONENTS];
+  uint32_t component_setup_ms[WAKE_PROFILE_COMPONENTS];
+};
+
+/// Called by Application::setup() with the time setup() of a component took, including waiting for it to proceed.
+void record_setup_duration(Component *component, uint32_t duration_ms);
+#endif
+
 template<typename... Ts> class EnterDeepSleepAction;
 
 template<typename... Ts> class PreventDeepSleepAction;
@@ -85,6 +108,8 @@ class DeepSleepComponent : public Component {
 
   /// Set a duration in ms for how long the code should run before entering deep sleep mode.
   void set_run_duration(uint32_t time_ms);
+  /// Don't set up the component when woken up by the timer, must be called before Application::setup().
+  void add_timer_wakeup_skip(Component *component);
 
   void setup() override;
   void dump_config() override;
@@ -102,6 +127,16 @@ class DeepSleepComponent : public Component {
   // Returns nullopt if no run duration is set. Otherwise, returns the run
   // duration before entering deep sleep.
   optional<uint32_t> get_run_duration_() const;
+  /// Whether this run started with a timer wakeup from deep sleep.
+  bool woke_up_by_timer_() const;
+#ifdef USE_DEEP_SLEEP_PROFILE
+  /// Record the connection milestones and report the previous wake once connected.
+  void update_profile_();
+  void save_profile_();
+
+  ESPPreferenceObject profile_pref_;
+  bool profile_reported_{false};
+#endif
 
   optional<uint64_t> sleep_duration_;
 #ifdef USE_ESP32
@@ -42,14 +42,31 @@ bool Dsmr::ready_to_request_data_() {
       this->start_requesting_data_();
     }
     if (!this->requesting_data_) {
-      while (this->available()) {
-        this->read();
-      }
+      this->drain_rx_();
     }
   }
   return this->requesting_data_;
 }
 
+void Dsmr::drain_rx_() {
+  this->read_buf_len_ = 0;
+  this->read_buf_pos_ = 0;
+  uint8_t buf[64];
+  while (this->read_available(buf, sizeof(buf)) > 0) {
+  }
+}
+
+bool Dsmr::read_buffered_(char *c) {
+  if (this->read_buf_pos_ >= this->read_buf_len_) {
+    this->read_buf_len_ = this->read_available(this->read_buf_, sizeof(this->read_buf_));
+    this->read_buf_pos_ = 0;
+    if (this->read_buf_len_ == 0)
+      return false;
+  }
+  *c = static_cast<char>(this->read_buf_[this->read_buf_pos_++]);
+  return true;
+}
+
 bool Dsmr::request_interval_reached_() {
   if (this->last_request_time_ == 0) {
     return true;
@@ -62,7 +79,7 @@ bool Dsmr::receive_timeout_reached_() { return millis() - this->last_read_time_
 bool Dsmr::available_within_timeout_() {
   // Data are available for reading on the UART bus?
   // Then we can start reading right away.
-  if (this->available()) {
+  if (this->read_buf_pos_ < this->read_buf_len_ || this->available()) {
     this->last_read_time_ = millis();
     return true;
   }
@@ -117,9 +134,7 @@ void Dsmr::stop_requesting_data_() {
     } else {
       ESP_LOGV(TAG, "Stop reading data from P1 port");
     }
-    while (this->available()) {
-      this->read();
-    }
+    this->drain_rx_();
     this->requesting_data_ = false;
   }
 }
@@ -135,7 +150,9 @@ void Dsmr::reset_telegram_() {
 
 void Dsmr::receive_telegram_() {
   while (this->available_within_timeout_()) {
-    const char c = this->read();
+    char c;
+    if (!this->read_buffered_(&c))
+      return;
 
     // Find a new telegram header, i.e. forward slash.
     if (c == '/') {
@@ -189,7 +206,9 @@ void Dsmr::receive_telegram_() {
 
 void Dsmr::receive_encrypted_telegram_() {
   while (this->available_within_timeout_()) {
-    const char c = this->read();
+    char c;
+    if (!this->read_buffered_(&c))
+      return;
 
     // Find a new telegram start byte.
     if (!this->header_found_) {
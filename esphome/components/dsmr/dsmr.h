@@ -100,6 +100,11 @@ class Dsmr : public Component, public uart::UARTDevice {
   /// time that the UART RX buffer overflows and bytes of the telegram get
   /// lost in the process.
   bool available_within_timeout_();
+  /// Next received byte, read from the UART in chunks. Only call after available_within_timeout_() returned true.
+  /// Returns false when the UART had nothing to read after all.
+  bool read_buffered_(char *c);
+  /// Discard everything that is in the UART RX buffer.
+  void drain_rx_();
 
   // Request telegram
   uint32_t request_interval_;
@@ -121,6 +126,10 @@ class Dsmr : public Component, public uart::UARTDevice {
   size_t crypt_telegram_len_{0};
   size_t crypt_bytes_read_{0};
   uint32_t last_read_time_{0};
+  /// Bytes read from the UART but not processed yet, kept when a telegram ends in the middle of a chunk.
+  uint8_t read_buf_[64];
+  size_t read_buf_len_{0};
+  size_t read_buf_pos_{0};
   bool header_found_{false};
   bool footer_found_{false};
 
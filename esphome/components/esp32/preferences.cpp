@@ -4,71 +4,92 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include <nvs_flash.h>
+#include <cinttypes>
+#include <cstdio>
 #include <cstring>
+#include <map>
 #include <vector>
-#include <string>
 
 namespace esphome {
 namespace esp32 {
 
 static const char *const TAG = "esp32.preferences";
 
-struct NVSData {
-  std::string key;
-  std::vector<uint8_t> data;
-};
+class ESP32PreferenceBackend;
 
-static std::vector<NVSData> s_pending_save;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static std::vector<ESP32PreferenceBackend *> s_pending_save;
 
+/// One per NVS key, shared by all preference objects made for it so they see each other's saves.
 class ESP32PreferenceBackend : public ESPPreferenceBackend {
  public:
-  std::string key;
+  /// Decimal representation of the type, the NVS key.
+  char key[11];
   uint32_t nvs_handle;
+  /// Data waiting for the next sync.
+  std::vector<uint8_t> pending;
+  bool has_pending{false};
+  /// Copy of what is stored in NVS, to find out whether a save changes anything without reading it back.
+  std::vector<uint8_t> stored;
+  bool stored_known{false};
+
   bool save(const uint8_t *data, size_t len) override {
-    // try find in pending saves and update that
-    for (auto &obj : s_pending_save) {
-      if (obj.key == key) {
-        obj.data.assign(data, data + len);
+    if (!this->has_pending) {
+      if (this->stored_known && this->stored.size() == len && memcmp(this->stored.data(), data, len) == 0)
         return true;
-      }
+      s_pending_save.push_back(this);
+      this->has_pending = true;
     }
-    NVSData save{};
-    save.key = key;
-    save.data.assign(data, data + len);
-    s_pending_save.emplace_back(save);
-    ESP_LOGVV(TAG, "s_pending_save: key: %s, len: %d", key.c_str(), len);
+    this->pending.assign(data, data + len);
+    ESP_LOGVV(TAG, "s_pending_save: key: %s, len: %d", this->key, len);
     return true;
   }
   bool load(uint8_t *data, size_t len) override {
-    // try find in pending saves and load from that
-    for (auto &obj : s_pending_save) {
-      if (obj.key == key) {
-        if (obj.data.size() != len) {
-          // size mismatch
-          return false;
-        }
-        memcpy(data, obj.data.data(), len);
-        return true;
+    // try the pending save first
+    if (this->has_pending) {
+      if (this->pending.size() != len) {
+        // size mismatch
+        return false;
       }
+      memcpy(data, this->pending.data(), len);
+      return true;
     }
 
-    size_t actual_len;
-    esp_err_t err = nvs_get_blob(nvs_handle, key.c_str(), nullptr, &actual_len);
-    if (err != 0) {
-      ESP_LOGV(TAG, "nvs_get_blob('%s'): %s - the key might not be set yet", key.c_str(), esp_err_to_name(err));
+    if (!this->read_stored_())
+      return false;
+    if (this->stored.size() != len) {
+      ESP_LOGVV(TAG, "NVS length does not match (%u!=%u)", this->stored.size(), len);
       return false;
     }
-    if (actual_len != len) {
-      ESP_LOGVV(TAG, "NVS length does not match (%u!=%u)", actual_len, len);
+    memcpy(data, this->stored.data(), len);
+    return true;
+  }
+
+  /// Whether the pending data differs from what is stored in NVS, which is only read if it's not known yet.
+  bool is_changed() {
+    if (!this->stored_known && !this->read_stored_())
+      return true;
+    return this->pending != this->stored;
+  }
+
+ protected:
+  bool read_stored_() {
+    if (this->stored_known)
+      return true;
+    size_t actual_len;
+    esp_err_t err = nvs_get_blob(this->nvs_handle, this->key, nullptr, &actual_len);
+    if (err != 0) {
+      ESP_LOGV(TAG, "nvs_get_blob('%s'): %s - the key might not be set yet", this->key, esp_err_to_name(err));
       return false;
     }
-    err = nvs_get_blob(nvs_handle, key.c_str(), data, &len);
+    this->stored.resize(actual_len);
+    err = nvs_get_blob(this->nvs_handle, this->key, this->stored.data(), &actual_len);
     if (err != 0) {
-      ESP_LOGV(TAG, "nvs_get_blob('%s') failed: %s", key.c_str(), esp_err_to_name(err));
+      ESP_LOGV(TAG, "nvs_get_blob('%s') failed: %s", this->key, esp_err_to_name(err));
       return false;
-    } else {
-      ESP_LOGVV(TAG, "nvs_get_blob: key: %s, len: %d", key.c_str(), len);
     }
+    ESP_LOGVV(TAG, "nvs_get_blob: key: %s, len: %d", this->key, actual_len);
+    this->stored_known = true;
     return true;
   }
 };
@@ -97,11 +118,15 @@ class ESP32Preferences : public ESPPreferences {
     return make_preference(length, type);
   }
   ESPPreferenceObject make_preference(size_t length, uint32_t type) override {
+    auto it = this->backends_.find(type);
+    if (it != this->backends_.end())
+      return ESPPreferenceObject(it->second);
+
     auto *pref = new ESP32PreferenceBackend();  // NOLINT(cppcoreguidelines-owning-memory)
     pref->nvs_handle = nvs_handle;
 
-    uint32_t keyval = type;
-    pref->key = str_sprintf("%u", keyval);
+    snprintf(pref->key, sizeof(pref->key), "%" PRIu32, type);
+    this->backends_[type] = pref;
 
     return ESPPreferenceObject(pref);
   }
@@ -114,36 +139,41 @@ class ESP32Preferences : public ESPPreferences {
     // goal try write all pending saves even if one fails
     int cached = 0, written = 0, failed = 0;
     esp_err_t last_err = ESP_OK;
-    std::string last_key{};
+    const char *last_key = "";
 
     // go through vector from back to front (makes erase easier/more efficient)
     for (ssize_t i = s_pending_save.size() - 1; i >= 0; i--) {
-      const auto &save = s_pending_save[i];
-      ESP_LOGVV(TAG, "Checking if NVS data %s has changed", save.key.c_str());
-      if (is_changed(nvs_handle, save)) {
-        esp_err_t err = nvs_set_blob(nvs_handle, save.key.c_str(), save.data.data(), save.data.size());
-        ESP_LOGV(TAG, "sync: key: %s, len: %d", save.key.c_str(), save.data.size());
+      auto *save = s_pending_save[i];
+      ESP_LOGVV(TAG, "Checking if NVS data %s has changed", save->key);
+      if (save->is_changed()) {
+        esp_err_t err = nvs_set_blob(nvs_handle, save->key, save->pending.data(), save->pending.size());
+        ESP_LOGV(TAG, "sync: key: %s, len: %d", save->key, save->pending.size());
         if (err != 0) {
-          ESP_LOGV(TAG, "nvs_set_blob('%s', len=%u) failed: %s", save.key.c_str(), save.data.size(),
-                   esp_err_to_name(err));
+          ESP_LOGV(TAG, "nvs_set_blob('%s', len=%u) failed: %s", save->key, save->pending.size(), esp_err_to_name(err));
           failed++;
           last_err = err;
-          last_key = save.key;
+          last_key = save->key;
           continue;
         }
         written++;
       } else {
-        ESP_LOGV(TAG, "NVS data not changed skipping %s  len=%u", save.key.c_str(), save.data.size());
+        ESP_LOGV(TAG, "NVS data not changed skipping %s  len=%u", save->key, save->pending.size());
         cached++;
       }
+      // the pending buffer becomes the stored copy, the old one is reused for the next save
+      std::swap(save->stored, save->pending);
+      save->stored_known = true;
+      save->has_pending = false;
       s_pending_save.erase(s_pending_save.begin() + i);
     }
     ESP_LOGD(TAG, "Saving %d preferences to flash: %d cached, %d written, %d failed", cached + written + failed, cached,
              written, failed);
     if (failed > 0) {
       ESP_LOGE(TAG, "Error saving %d preferences to flash. Last error=%s for key=%s", failed, esp_err_to_name(last_err),
-               last_key.c_str());
+               last_key);
     }
+    if (written == 0)
+      return failed == 0;
 
     // note: commit on esp-idf currently is a no-op, nvs_set_blob always writes
     esp_err_t err = nvs_commit(nvs_handle);
@@ -154,26 +184,14 @@ class ESP32Preferences : public ESPPreferences {
 
     return failed == 0;
   }
-  bool is_changed(const uint32_t nvs_handle, const NVSData &to_save) {
-    NVSData stored_data{};
-    size_t actual_len;
-    esp_err_t err = nvs_get_blob(nvs_handle, to_save.key.c_str(), nullptr, &actual_len);
-    if (err != 0) {
-      ESP_LOGV(TAG, "nvs_get_blob('%s'): %s - the key might not be set yet", to_save.key.c_str(), esp_err_to_name(err));
-      return true;
-    }
-    stored_data.data.resize(actual_len);
-    err = nvs_get_blob(nvs_handle, to_save.key.c_str(), stored_data.data.data(), &actual_len);
-    if (err != 0) {
-      ESP_LOGV(TAG, "nvs_get_blob('%s') failed: %s", to_save.key.c_str(), esp_err_to_name(err));
-      return true;
-    }
-    return to_save.data != stored_data.data;
-  }
 
   bool reset() override {
     ESP_LOGD(TAG, "Cleaning up preferences in flash...");
     s_pending_save.clear();
+    for (auto &entry : this->backends_) {
+      entry.second->has_pending = false;
+      entry.second->stored_known = false;
+    }
 
     nvs_flash_deinit();
     nvs_flash_erase();
@@ -181,6 +199,9 @@ class ESP32Preferences : public ESPPreferences {
     nvs_handle = 0;
     return true;
   }
+
+ protected:
+  std::map<uint32_t, ESP32PreferenceBackend *> backends_;
 };
 
 void setup_preferences() {
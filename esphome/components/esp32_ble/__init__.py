@@ -16,6 +16,7 @@ esp32_ble_ns = cg.esphome_ns.namespace("esp32_ble")
 ESP32BLE = esp32_ble_ns.class_("ESP32BLE", cg.Component)
 
 GAPEventHandler = esp32_ble_ns.class_("GAPEventHandler")
+GAPScanEventHandler = esp32_ble_ns.class_("GAPScanEventHandler")
 GATTcEventHandler = esp32_ble_ns.class_("GATTcEventHandler")
 GATTsEventHandler = esp32_ble_ns.class_("GATTsEventHandler")
 
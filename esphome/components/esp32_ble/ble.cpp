@@ -94,7 +94,7 @@ bool ESP32BLE::ble_setup_() {
     return false;
   }
 
-  if (!this->gap_event_handlers_.empty()) {
+  if (!this->gap_event_handlers_.empty() || !this->gap_scan_event_handlers_.empty()) {
     err = esp_ble_gap_register_callback(ESP32BLE::gap_event_handler);
     if (err != ESP_OK) {
       ESP_LOGE(TAG, "esp_ble_gap_register_callback failed: %d", err);
@@ -170,6 +170,12 @@ void ESP32BLE::loop() {
 }
 
 void ESP32BLE::gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) {
+  if (event == ESP_GAP_BLE_SCAN_RESULT_EVT && param->scan_rst.search_evt == ESP_GAP_SEARCH_INQ_RES_EVT &&
+      !global_ble->gap_scan_event_handlers_.empty()) {
+    for (auto *scan_handler : global_ble->gap_scan_event_handlers_)
+      scan_handler->gap_scan_event_handler(param->scan_rst);
+    return;
+  }
   BLEEvent *new_event = new BLEEvent(event, param);  // NOLINT(cppcoreguidelines-owning-memory)
   global_ble->ble_events_.push(new_event);
 }  // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
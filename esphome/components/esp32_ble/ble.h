@@ -30,6 +30,16 @@ class GAPEventHandler {
   virtual void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) = 0;
 };
 
+/** Receives advertisements directly in the Bluetooth task, instead of through the event queue of ESP32BLE.
+ *
+ * Scan results arrive at a high rate, so they skip the allocation and locking of the event queue. The handler is
+ * called concurrently with the main loop and must not block.
+ */
+class GAPScanEventHandler {
+ public:
+  virtual void gap_scan_event_handler(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) = 0;
+};
+
 class GATTcEventHandler {
  public:
   virtual void gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
@@ -52,6 +62,9 @@ class ESP32BLE : public Component {
   BLEAdvertising *get_advertising() { return this->advertising_; }
 
   void register_gap_event_handler(GAPEventHandler *handler) { this->gap_event_handlers_.push_back(handler); }
+  void register_gap_scan_event_handler(GAPScanEventHandler *handler) {
+    this->gap_scan_event_handlers_.push_back(handler);
+  }
   void register_gattc_event_handler(GATTcEventHandler *handler) { this->gattc_event_handlers_.push_back(handler); }
   void register_gatts_event_handler(GATTsEventHandler *handler) { this->gatts_event_handlers_.push_back(handler); }
 
@@ -67,6 +80,7 @@ class ESP32BLE : public Component {
   bool ble_setup_();
 
   std::vector<GAPEventHandler *> gap_event_handlers_;
+  std::vector<GAPScanEventHandler *> gap_scan_event_handlers_;
   std::vector<GATTcEventHandler *> gattc_event_handlers_;
   std::vector<GATTsEventHandler *> gatts_event_handlers_;
 
@@ -27,11 +27,15 @@ CONF_SCAN_PARAMETERS = "scan_parameters"
 CONF_WINDOW = "window"
 CONF_CONTINUOUS = "continuous"
 CONF_ON_SCAN_END = "on_scan_end"
+CONF_SCAN_RESULT_BUFFER_SIZE = "scan_result_buffer_size"
+CONF_DEDUP_WINDOW = "dedup_window"
+CONF_ADVERTISEMENT_CACHE_SIZE = "advertisement_cache_size"
 esp32_ble_tracker_ns = cg.esphome_ns.namespace("esp32_ble_tracker")
 ESP32BLETracker = esp32_ble_tracker_ns.class_(
     "ESP32BLETracker",
     cg.Component,
     esp32_ble.GAPEventHandler,
+    esp32_ble.GAPScanEventHandler,
     esp32_ble.GATTcEventHandler,
     cg.Parented.template(esp32_ble.ESP32BLE),
 )
@@ -164,6 +168,17 @@ CONFIG_SCHEMA = cv.Schema(
             ),
             validate_scan_parameters,
         ),
+        cv.Optional(CONF_SCAN_RESULT_BUFFER_SIZE, default=32): cv.int_range(
+            min=4, max=1024
+        ),
+        cv.Optional(
+            CONF_DEDUP_WINDOW, default="0s"
+        ): cv.positive_time_period_milliseconds,
+        # should be larger than the number of advertisers in range, or the dedup window
+        # doesn't apply to the least recently seen ones
+        cv.Optional(CONF_ADVERTISEMENT_CACHE_SIZE, default=128): cv.int_range(
+            min=16, max=4096
+        ),
         cv.Optional(CONF_ON_BLE_ADVERTISE): automation.validate_automation(
             {
                 cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ESPBTAdvertiseTrigger),
@@ -211,6 +226,7 @@ async def to_code(config):
 
     parent = await cg.get_variable(config[esp32_ble.CONF_BLE_ID])
     cg.add(parent.register_gap_event_handler(var))
+    cg.add(parent.register_gap_scan_event_handler(var))
     cg.add(parent.register_gattc_event_handler(var))
     cg.add(var.set_parent(parent))
 
@@ -220,6 +236,9 @@ async def to_code(config):
     cg.add(var.set_scan_window(int(params[CONF_WINDOW].total_milliseconds / 0.625)))
     cg.add(var.set_scan_active(params[CONF_ACTIVE]))
     cg.add(var.set_scan_continuous(params[CONF_CONTINUOUS]))
+    cg.add(var.set_scan_result_buffer_size(config[CONF_SCAN_RESULT_BUFFER_SIZE]))
+    cg.add(var.set_dedup_window(config[CONF_DEDUP_WINDOW]))
+    cg.add(var.set_advertisement_cache_size(config[CONF_ADVERTISEMENT_CACHE_SIZE]))
     for conf in config.get(CONF_ON_BLE_ADVERTISE, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
         if CONF_MAC_ADDRESS in conf:
@@ -309,9 +328,24 @@ async def esp32_ble_tracker_stop_scan_action_to_code(
     return var
 
 
-async def register_ble_device(var, config):
+async def register_ble_device(var, config, manufacturer_id=None, service_uuid=None):
+    """Register a device listener with the tracker.
+
+    If the config has a MAC address, the listener is only offered advertisements from that
+    address. Otherwise it can be restricted to advertisements with a 16-bit manufacturer_id
+    or service_uuid (listed or with service data), or is offered all advertisements.
+    """
     paren = await cg.get_variable(config[CONF_ESP32_BLE_ID])
-    cg.add(paren.register_listener(var))
+    if CONF_MAC_ADDRESS in config:
+        cg.add(
+            paren.register_listener_by_address(var, config[CONF_MAC_ADDRESS].as_hex)
+        )
+    elif manufacturer_id is not None:
+        cg.add(paren.register_listener_by_manufacturer_id(var, manufacturer_id))
+    elif service_uuid is not None:
+        cg.add(paren.register_listener_by_service_uuid(var, service_uuid))
+    else:
+        cg.add(paren.register_listener(var))
     return var
 
 
@@ -0,0 +1,83 @@
+#include "advertisement_cache.h"
+
+#ifdef USE_ESP32
+
+#include "esphome/core/helpers.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace esp32_ble_tracker {
+
+/// How many consecutive slots an address may be placed in, bounds the cost of a miss.
+static const size_t MAX_PROBES = 8;
+
+bool AdvertisementCache::init(size_t capacity) {
+  size_t slots = 1;
+  while (slots < capacity)
+    slots <<= 1;
+  ExternalRAMAllocator<Entry> allocator(ExternalRAMAllocator<Entry>::ALLOW_FAILURE);
+  this->entries_ = allocator.allocate(slots);
+  if (this->entries_ == nullptr)
+    return false;
+  this->mask_ = slots - 1;
+  this->clear();
+  return true;
+}
+
+void AdvertisementCache::clear() {
+  if (this->entries_ != nullptr)
+    memset(this->entries_, 0, sizeof(Entry) * this->get_capacity());
+}
+
+bool AdvertisementCache::should_deliver(uint64_t address, bool scan_response, uint32_t payload_hash, uint32_t now,
+                                        uint32_t window_ms) {
+  Entry *entry = this->get_(address, now);
+  if (entry == nullptr)
+    return true;
+  const uint8_t delivered = scan_response ? FLAG_DELIVERED_SCAN_RESPONSE : FLAG_DELIVERED_ADV;
+  const size_t kind = scan_response ? 1 : 0;
+  if ((entry->flags & delivered) != 0 && entry->payload_hash[kind] == payload_hash &&
+      now - entry->delivered_at[kind] < window_ms)
+    return false;
+  entry->flags |= delivered;
+  entry->payload_hash[kind] = payload_hash;
+  entry->delivered_at[kind] = now;
+  return true;
+}
+
+AdvertisementCache::Entry *AdvertisementCache::get_(uint64_t address, uint32_t now) {
+  if (this->entries_ == nullptr)
+    return nullptr;
+
+  // the low bits of a MAC address are the most random ones, but mix in the rest for vendor-assigned patterns
+  size_t index = (address ^ (address >> 24)) & this->mask_;
+  const size_t probes = std::min(MAX_PROBES, this->get_capacity());
+  Entry *victim = nullptr;
+  for (size_t i = 0; i < probes; i++, index = (index + 1) & this->mask_) {
+    Entry *entry = &this->entries_[index];
+    if ((entry->flags & FLAG_USED) == 0) {
+      // entries are never removed, so the address can't be further along
+      victim = entry;
+      break;
+    }
+    if (entry->address == address) {
+      entry->last_seen = now;
+      return entry;
+    }
+    if (victim == nullptr || now - entry->last_seen > now - victim->last_seen)
+      victim = entry;
+  }
+
+  *victim = Entry{};
+  victim->address = address;
+  victim->last_seen = now;
+  victim->flags = FLAG_USED;
+  return victim;
+}
+
+}  // namespace esp32_ble_tracker
+}  // namespace esphome
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#ifdef USE_ESP32
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace esp32_ble_tracker {
+
+/** Fixed-size table of recently seen advertisers, keyed by MAC address.
+ *
+ * Remembers a hash of the last advertisement and scan response payload of each address, so the tracker can skip
+ * advertisements that did not change since they were last delivered to the listeners. Uses open addressing with
+ * linear probing over a table that is allocated once (in PSRAM if available). Entries are never removed, only
+ * replaced: when an address doesn't fit in its probe window, the least recently seen entry of that window is evicted.
+ * An evicted address is simply treated as new again.
+ */
+class AdvertisementCache {
+ public:
+  /// Allocate the table, capacity is rounded up to a power of two.
+  bool init(size_t capacity);
+  /// Forget all addresses.
+  void clear();
+
+  /** Whether an advertisement should be delivered to the listeners.
+   *
+   * Returns false if the same payload of the same kind (advertisement or scan response) was delivered for this address
+   * less than window_ms ago. Otherwise records it as delivered now and returns true.
+   */
+  bool should_deliver(uint64_t address, bool scan_response, uint32_t payload_hash, uint32_t now, uint32_t window_ms);
+
+  size_t get_capacity() const { return this->mask_ == 0 ? 0 : this->mask_ + 1; }
+
+ protected:
+  static const uint8_t FLAG_USED = 1 << 0;
+  static const uint8_t FLAG_DELIVERED_ADV = 1 << 1;
+  static const uint8_t FLAG_DELIVERED_SCAN_RESPONSE = 1 << 2;
+
+  struct Entry {
+    uint64_t address;
+    /// Indexed by scan response.
+    uint32_t payload_hash[2];
+    uint32_t delivered_at[2];
+    uint32_t last_seen;
+    uint8_t flags;
+  };
+
+  /// The entry for address, creating it if needed. Returns nullptr if the table could not be allocated.
+  Entry *get_(uint64_t address, uint32_t now);
+
+  Entry *entries_{nullptr};
+  size_t mask_{0};
+};
+
+}  // namespace esp32_ble_tracker
+}  // namespace esphome
+
+#endif
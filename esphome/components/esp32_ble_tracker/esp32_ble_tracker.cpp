@@ -7,6 +7,9 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <esp_bt.h>
 #include <esp_bt_defs.h>
 #include <esp_bt_main.h>
@@ -32,6 +35,9 @@ namespace esp32_ble_tracker {
 
 static const char *const TAG = "esp32_ble_tracker";
 
+static const uint32_t SCAN_RESULT_LOOP_BUDGET_MS = 10;
+static const uint32_t SCAN_RESULT_DROP_WARNING_INTERVAL_MS = 10000;
+
 ESP32BLETracker *global_esp32_ble_tracker = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 uint64_t ble_addr_to_uint64(const esp_bd_addr_t address) {
@@ -54,8 +60,18 @@ void ESP32BLETracker::setup() {
     return;
   }
 
+  if (!this->scan_result_ring_.init(this->scan_result_buffer_size_)) {
+    ESP_LOGE(TAG, "Could not allocate buffer for %u scan results!", this->scan_result_buffer_size_);
+    this->mark_failed();
+    return;
+  }
+  if (this->dedup_window_ != 0 && !this->advertisement_cache_.init(this->advertisement_cache_size_)) {
+    ESP_LOGE(TAG, "Could not allocate advertisement cache!");
+    this->mark_failed();
+    return;
+  }
+
   global_esp32_ble_tracker = this;
-  this->scan_result_lock_ = xSemaphoreCreateMutex();
   this->scan_end_lock_ = xSemaphoreCreateMutex();
   this->scanner_idle_ = true;
 
@@ -103,40 +119,7 @@ void ESP32BLETracker::loop() {
   bool promote_to_connecting = discovered && !searching && !connecting;
 
   if (!this->scanner_idle_) {
-    if (this->scan_result_index_ &&  // if it looks like we have a scan result we will take the lock
-        xSemaphoreTake(this->scan_result_lock_, 5L / portTICK_PERIOD_MS)) {
-      uint32_t index = this->scan_result_index_;
-      if (index) {
-        if (index >= 16) {
-          ESP_LOGW(TAG, "Too many BLE events to process. Some devices may not show up.");
-        }
-        for (size_t i = 0; i < index; i++) {
-          ESPBTDevice device;
-          device.parse_scan_rst(this->scan_result_buffer_[i]);
-
-          bool found = false;
-          for (auto *listener : this->listeners_) {
-            if (listener->parse_device(device))
-              found = true;
-          }
-
-          for (auto *client : this->clients_) {
-            if (client->parse_device(device)) {
-              found = true;
-              if (!connecting && client->state() == ClientState::DISCOVERED) {
-                promote_to_connecting = true;
-              }
-            }
-          }
-
-          if (!found && !this->scan_continuous_) {
-            this->print_bt_device_info(device);
-          }
-        }
-        this->scan_result_index_ = 0;
-      }
-      xSemaphoreGive(this->scan_result_lock_);
-    }
+    this->process_scan_results_(connecting, promote_to_connecting);
 
     /*
 
@@ -213,6 +196,144 @@ void ESP32BLETracker::loop() {
   }
 }
 
+void ESP32BLETracker::process_scan_results_(int connecting, bool &promote_to_connecting) {
+  // Bounded, so a busy radio can't starve the rest of the loop; the ring buffers the remainder.
+  const uint32_t start = millis();
+  size_t processed = 0;
+  const ScanResultRing::ScanResult *result;
+  while (processed < this->scan_result_ring_.get_capacity() && millis() - start < SCAN_RESULT_LOOP_BUDGET_MS &&
+         (result = this->scan_result_ring_.front()) != nullptr) {
+    if (this->dedup_window_ != 0 && !this->should_deliver_(*result)) {
+      this->scan_result_ring_.pop();
+      processed++;
+      this->scan_results_deduplicated_++;
+      continue;
+    }
+    ESPBTDevice device;
+    device.parse_scan_rst(*result);
+    this->scan_result_ring_.pop();
+    processed++;
+
+    bool found = this->dispatch_to_listeners_(device);
+
+    for (auto *client : this->clients_) {
+      if (client->parse_device(device)) {
+        found = true;
+        if (!connecting && client->state() == ClientState::DISCOVERED) {
+          promote_to_connecting = true;
+        }
+      }
+    }
+
+    if (!found && !this->scan_continuous_) {
+      this->print_bt_device_info(device);
+    }
+  }
+
+  const uint32_t dropped = this->scan_result_ring_.get_dropped();
+  if (dropped != this->scan_results_dropped_reported_ &&
+      millis() - this->scan_results_dropped_warned_ > SCAN_RESULT_DROP_WARNING_INTERVAL_MS) {
+    ESP_LOGW(TAG, "Too many BLE events to process, dropped %u advertisements. Some devices may not show up.",
+             dropped - this->scan_results_dropped_reported_);
+    this->scan_results_dropped_reported_ = dropped;
+    this->scan_results_dropped_warned_ = millis();
+  }
+}
+
+bool ESP32BLETracker::should_deliver_(const ScanResultRing::ScanResult &result) {
+  const uint32_t payload_hash = fnv1_hash(result.ble_adv, result.adv_data_len + result.scan_rsp_len);
+  return this->advertisement_cache_.should_deliver(ble_addr_to_uint64(result.bda),
+                                                   result.ble_evt_type == ESP_BLE_EVT_SCAN_RSP, payload_hash,
+                                                   millis(), this->dedup_window_);
+}
+
+// Bluetooth Base UUID 0000xxxx-0000-1000-8000-00805F9B34FB, in the little endian order used over the air.
+static const uint8_t BLE_BASE_UUID[16] = {0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80,
+                                          0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static inline uint16_t read_uint16(const uint8_t *data) { return data[0] | (data[1] << 8); }
+
+bool ESP32BLETracker::dispatch_to_listeners_(const ESPBTDevice &device) {
+  bool found = false;
+  for (auto *listener : this->wildcard_listeners_) {
+    if (listener->parse_device(device))
+      found = true;
+  }
+
+  this->offered_listeners_.clear();
+  if (!this->address_listeners_.empty()) {
+    auto it = this->address_listeners_.find(device.address_uint64());
+    if (it != this->address_listeners_.end() && this->offer_to_listeners_(device, it->second))
+      found = true;
+  }
+  if (this->manufacturer_listeners_.empty() && this->service_listeners_.empty())
+    return found;
+
+  auto offer_manufacturer = [&](uint16_t id) {
+    auto it = this->manufacturer_listeners_.find(id);
+    if (it != this->manufacturer_listeners_.end() && this->offer_to_listeners_(device, it->second))
+      found = true;
+  };
+  auto offer_service = [&](uint16_t uuid) {
+    auto it = this->service_listeners_.find(uuid);
+    if (it != this->service_listeners_.end() && this->offer_to_listeners_(device, it->second))
+      found = true;
+  };
+
+  // Walk the raw AD structures, so advertisements nobody is interested in are never decoded.
+  for (const auto &record : device.get_adv_data()) {
+    switch (record.type) {
+      case ESP_BLE_AD_MANUFACTURER_SPECIFIC_TYPE:
+        if (record.length >= 2)
+          offer_manufacturer(read_uint16(record.data));
+        break;
+      case ESP_BLE_AD_TYPE_SERVICE_DATA:
+        if (record.length >= 2)
+          offer_service(read_uint16(record.data));
+        break;
+      case ESP_BLE_AD_TYPE_16SRV_CMPL:
+      case ESP_BLE_AD_TYPE_16SRV_PART:
+        for (uint8_t i = 0; i + 2 <= record.length; i += 2)
+          offer_service(read_uint16(record.data + i));
+        break;
+      case ESP_BLE_AD_TYPE_32SRV_CMPL:
+      case ESP_BLE_AD_TYPE_32SRV_PART:
+        // 16-bit UUIDs may also be sent in their 32-bit form
+        for (uint8_t i = 0; i + 4 <= record.length; i += 4) {
+          if (read_uint16(record.data + i + 2) == 0)
+            offer_service(read_uint16(record.data + i));
+        }
+        break;
+      case ESP_BLE_AD_TYPE_128SRV_CMPL:
+      case ESP_BLE_AD_TYPE_128SRV_PART:
+        // ... or in their 128-bit form, based on the Bluetooth Base UUID
+        for (uint8_t i = 0; i + 16 <= record.length; i += 16) {
+          const uint8_t *uuid = record.data + i;
+          if (memcmp(uuid, BLE_BASE_UUID, 12) == 0 && uuid[14] == 0 && uuid[15] == 0)
+            offer_service(read_uint16(uuid + 12));
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return found;
+}
+
+bool ESP32BLETracker::offer_to_listeners_(const ESPBTDevice &device,
+                                          const std::vector<ESPBTDeviceListener *> &listeners) {
+  bool found = false;
+  for (auto *listener : listeners) {
+    if (std::find(this->offered_listeners_.begin(), this->offered_listeners_.end(), listener) !=
+        this->offered_listeners_.end())
+      continue;
+    this->offered_listeners_.push_back(listener);
+    if (listener->parse_device(device))
+      found = true;
+  }
+  return found;
+}
+
 void ESP32BLETracker::start_scan() {
   if (xSemaphoreTake(this->scan_end_lock_, 0L)) {
     this->start_scan_(true);
@@ -240,7 +361,8 @@ void ESP32BLETracker::start_scan_(bool first) {
     for (auto *listener : this->listeners_)
       listener->on_scan_end();
   }
-  this->already_discovered_.clear();
+  this->advertisement_cache_.clear();
+  this->printed_addresses_.clear();
   this->scanner_idle_ = false;
   this->scan_params_.scan_type = this->scan_active_ ? BLE_SCAN_TYPE_ACTIVE : BLE_SCAN_TYPE_PASSIVE;
   this->scan_params_.own_addr_type = BLE_ADDR_TYPE_PUBLIC;
@@ -266,7 +388,8 @@ void ESP32BLETracker::end_of_scan_() {
 
   ESP_LOGD(TAG, "End of scan.");
   this->scanner_idle_ = true;
-  this->already_discovered_.clear();
+  this->advertisement_cache_.clear();
+  this->printed_addresses_.clear();
   xSemaphoreGive(this->scan_end_lock_);
   this->cancel_timeout("scan");
 
@@ -274,6 +397,31 @@ void ESP32BLETracker::end_of_scan_() {
     listener->on_scan_end();
 }
 
+void ESP32BLETracker::add_listener_(ESPBTDeviceListener *listener) {
+  listener->set_parent(this);
+  this->listeners_.push_back(listener);
+}
+
+void ESP32BLETracker::register_listener(ESPBTDeviceListener *listener) {
+  this->add_listener_(listener);
+  this->wildcard_listeners_.push_back(listener);
+}
+
+void ESP32BLETracker::register_listener_by_address(ESPBTDeviceListener *listener, uint64_t address) {
+  this->add_listener_(listener);
+  this->address_listeners_[address].push_back(listener);
+}
+
+void ESP32BLETracker::register_listener_by_manufacturer_id(ESPBTDeviceListener *listener, uint16_t manufacturer_id) {
+  this->add_listener_(listener);
+  this->manufacturer_listeners_[manufacturer_id].push_back(listener);
+}
+
+void ESP32BLETracker::register_listener_by_service_uuid(ESPBTDeviceListener *listener, uint16_t service_uuid) {
+  this->add_listener_(listener);
+  this->service_listeners_[service_uuid].push_back(listener);
+}
+
 void ESP32BLETracker::register_client(ESPBTClient *client) {
   client->app_id = ++this->app_id_;
   this->clients_.push_back(client);
@@ -319,15 +467,14 @@ void ESP32BLETracker::gap_scan_stop_complete_(const esp_ble_gap_cb_param_t::ble_
   xSemaphoreGive(this->scan_end_lock_);
 }
 
+void ESP32BLETracker::gap_scan_event_handler(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) {
+  // Runs in the Bluetooth task.
+  this->scan_result_ring_.push(param);
+}
+
 void ESP32BLETracker::gap_scan_result_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) {
-  if (param.search_evt == ESP_GAP_SEARCH_INQ_RES_EVT) {
-    if (xSemaphoreTake(this->scan_result_lock_, 0L)) {
-      if (this->scan_result_index_ < 16) {
-        this->scan_result_buffer_[this->scan_result_index_++] = param;
-      }
-      xSemaphoreGive(this->scan_result_lock_);
-    }
-  } else if (param.search_evt == ESP_GAP_SEARCH_INQ_CMPL_EVT) {
+  // Advertisements (ESP_GAP_SEARCH_INQ_RES_EVT) arrive through gap_scan_event_handler().
+  if (param.search_evt == ESP_GAP_SEARCH_INQ_CMPL_EVT) {
     xSemaphoreGive(this->scan_end_lock_);
   }
 }
@@ -355,7 +502,7 @@ void ESPBTDevice::parse_scan_rst(const esp_ble_gap_cb_param_t::ble_scan_result_e
     this->address_[i] = param.bda[i];
   this->address_type_ = param.ble_addr_type;
   this->rssi_ = param.rssi;
-  this->parse_adv_(param);
+  this->adv_decoded_ = false;
 
 #ifdef ESPHOME_LOG_HAS_VERY_VERBOSE
   ESP_LOGVV(TAG, "Parse Result:");
@@ -378,7 +525,7 @@ void ESPBTDevice::parse_scan_rst(const esp_ble_gap_cb_param_t::ble_scan_result_e
             this->address_[2], this->address_[3], this->address_[4], this->address_[5], address_type);
 
   ESP_LOGVV(TAG, "  RSSI: %d", this->rssi_);
-  ESP_LOGVV(TAG, "  Name: '%s'", this->name_.c_str());
+  ESP_LOGVV(TAG, "  Name: '%s'", this->get_name().c_str());
   for (auto &it : this->tx_powers_) {
     ESP_LOGVV(TAG, "  TX Power: %d", it);
   }
@@ -411,22 +558,52 @@ void ESPBTDevice::parse_scan_rst(const esp_ble_gap_cb_param_t::ble_scan_result_e
   ESP_LOGVV(TAG, "Adv data: %s", format_hex_pretty(param.ble_adv, param.adv_data_len + param.scan_rsp_len).c_str());
 #endif
 }
-void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) {
-  size_t offset = 0;
-  const uint8_t *payload = param.ble_adv;
-  uint8_t len = param.adv_data_len + param.scan_rsp_len;
-
-  while (offset + 2 < len) {
-    const uint8_t field_length = payload[offset++];  // First byte is length of adv record
+void AdvDataView::Iterator::advance_() {
+  while (this->offset_ + 2 < this->length_) {
+    const uint8_t field_length = this->payload_[this->offset_++];  // First byte is length of adv record
     if (field_length == 0) {
       continue;  // Possible zero padded advertisement data
     }
 
     // first byte of adv record is adv record type
-    const uint8_t record_type = payload[offset++];
-    const uint8_t *record = &payload[offset];
+    const uint8_t record_type = this->payload_[this->offset_++];
     const uint8_t record_length = field_length - 1;
-    offset += record_length;
+    if (this->offset_ + record_length > this->length_) {
+      ESP_LOGV(TAG, "Truncated advertisement record of type 0x%02x", record_type);
+      break;
+    }
+    this->record_ = AdvRecord{record_type, &this->payload_[this->offset_], record_length};
+    this->offset_ += record_length;
+    return;
+  }
+  this->offset_ = this->length_;
+  this->record_ = AdvRecord{0, nullptr, 0};
+}
+
+optional<AdvRecord> AdvDataView::find(uint8_t type) const {
+  for (const auto &record : *this) {
+    if (record.type == type)
+      return record;
+  }
+  return {};
+}
+
+void ESPBTDevice::decode_adv_() const {
+  if (this->adv_decoded_)
+    return;
+  this->adv_decoded_ = true;
+  this->name_.clear();
+  this->tx_powers_.clear();
+  this->appearance_.reset();
+  this->ad_flag_.reset();
+  this->service_uuids_.clear();
+  this->manufacturer_datas_.clear();
+  this->service_datas_.clear();
+
+  for (const auto &adv_record : this->get_adv_data()) {
+    const uint8_t record_type = adv_record.type;
+    const uint8_t *record = adv_record.data;
+    const uint8_t record_length = adv_record.length;
 
     // See also Generic Access Profile Assigned Numbers:
     // https://www.bluetooth.com/specifications/assigned-numbers/generic-access-profile/ See also ADVERTISING AND SCAN
@@ -452,7 +629,7 @@ void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_p
         // CSS 1.5 TX POWER LEVEL
         // "The TX Power Level data type indicates the transmitted power level of the packet containing the data type."
         // CSS 1: Optional in this context (may appear more than once in a block).
-        this->tx_powers_.push_back(*payload);
+        this->tx_powers_.push_back(*record);
         break;
       }
       case ESP_BLE_AD_TYPE_APPEARANCE: {
@@ -586,15 +763,20 @@ void ESP32BLETracker::dump_config() {
   ESP_LOGCONFIG(TAG, "  Scan Window: %.1f ms", this->scan_window_ * 0.625f);
   ESP_LOGCONFIG(TAG, "  Scan Type: %s", this->scan_active_ ? "ACTIVE" : "PASSIVE");
   ESP_LOGCONFIG(TAG, "  Continuous Scanning: %s", this->scan_continuous_ ? "True" : "False");
+  ESP_LOGCONFIG(TAG, "  Scan Result Buffer Size: %u", this->scan_result_ring_.get_capacity());
+  if (this->dedup_window_ != 0) {
+    ESP_LOGCONFIG(TAG, "  Dedup Window: %u ms", this->dedup_window_);
+    ESP_LOGCONFIG(TAG, "  Advertisement Cache Size: %u", this->advertisement_cache_.get_capacity());
+  }
 }
 
 void ESP32BLETracker::print_bt_device_info(const ESPBTDevice &device) {
+  // sorted, so a busy environment doesn't make every advertisement scan the whole list
   const uint64_t address = device.address_uint64();
-  for (auto &disc : this->already_discovered_) {
-    if (disc == address)
-      return;
-  }
-  this->already_discovered_.push_back(address);
+  auto it = std::lower_bound(this->printed_addresses_.begin(), this->printed_addresses_.end(), address);
+  if (it != this->printed_addresses_.end() && *it == address)
+    return;
+  this->printed_addresses_.insert(it, address);
 
   ESP_LOGD(TAG, "Found device %s RSSI=%d", device.address_str().c_str(), device.get_rssi());
 
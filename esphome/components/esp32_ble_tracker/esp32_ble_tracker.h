@@ -6,6 +6,7 @@
 
 #include <array>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #ifdef USE_ESP32
@@ -20,6 +21,9 @@
 #include "esphome/components/esp32_ble/ble.h"
 #include "esphome/components/esp32_ble/ble_uuid.h"
 
+#include "advertisement_cache.h"
+#include "scan_result_ring.h"
+
 namespace esphome {
 namespace esp32_ble_tracker {
 
@@ -54,6 +58,65 @@ class ESPBLEiBeacon {
   } PACKED beacon_data_;
 };
 
+/// One AD structure of an advertisement, pointing into the raw payload.
+struct AdvRecord {
+  uint8_t type;
+  const uint8_t *data;
+  uint8_t length;
+};
+
+/** Iterates over the AD structures of a raw advertisement payload, without copying or allocating.
+ *
+ * Use this instead of the decoded getters of ESPBTDevice when only one field of an advertisement is needed.
+ */
+class AdvDataView {
+ public:
+  class Iterator {
+   public:
+    Iterator(const uint8_t *payload, uint8_t length, uint8_t offset)
+        : payload_(payload), length_(length), offset_(offset) {
+      this->advance_();
+    }
+    const AdvRecord &operator*() const { return this->record_; }
+    const AdvRecord *operator->() const { return &this->record_; }
+    Iterator &operator++() {
+      this->advance_();
+      return *this;
+    }
+    bool operator==(const Iterator &other) const { return this->record_.data == other.record_.data; }
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+
+   protected:
+    void advance_();
+
+    const uint8_t *payload_;
+    uint8_t length_;
+    uint8_t offset_;
+    AdvRecord record_{0, nullptr, 0};
+  };
+
+  AdvDataView(const uint8_t *payload, uint8_t length) : payload_(payload), length_(length) {}
+
+  Iterator begin() const { return Iterator(this->payload_, this->length_, 0); }
+  Iterator end() const { return Iterator(this->payload_, this->length_, this->length_); }
+
+  /// The first AD structure of the given type (ESP_BLE_AD_TYPE_*).
+  optional<AdvRecord> find(uint8_t type) const;
+
+  /// The whole payload, as received over the air.
+  const uint8_t *data() const { return this->payload_; }
+  uint8_t size() const { return this->length_; }
+
+ protected:
+  const uint8_t *payload_;
+  uint8_t length_;
+};
+
+/** A received advertisement.
+ *
+ * parse_scan_rst() only stores the raw scan result. The AD structures are decoded into the vectors and strings below
+ * the first time one of them is requested, so listeners that only look at the address don't pay for it.
+ */
 class ESPBTDevice {
  public:
   void parse_scan_rst(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param);
@@ -66,22 +129,48 @@ class ESPBTDevice {
 
   esp_ble_addr_type_t get_address_type() const { return this->address_type_; }
   int get_rssi() const { return rssi_; }
-  const std::string &get_name() const { return this->name_; }
+  const std::string &get_name() const {
+    this->decode_adv_();
+    return this->name_;
+  }
 
-  const std::vector<int8_t> &get_tx_powers() const { return tx_powers_; }
+  const std::vector<int8_t> &get_tx_powers() const {
+    this->decode_adv_();
+    return tx_powers_;
+  }
 
-  const optional<uint16_t> &get_appearance() const { return appearance_; }
-  const optional<uint8_t> &get_ad_flag() const { return ad_flag_; }
-  const std::vector<ESPBTUUID> &get_service_uuids() const { return service_uuids_; }
+  const optional<uint16_t> &get_appearance() const {
+    this->decode_adv_();
+    return appearance_;
+  }
+  const optional<uint8_t> &get_ad_flag() const {
+    this->decode_adv_();
+    return ad_flag_;
+  }
+  const std::vector<ESPBTUUID> &get_service_uuids() const {
+    this->decode_adv_();
+    return service_uuids_;
+  }
 
-  const std::vector<ServiceData> &get_manufacturer_datas() const { return manufacturer_datas_; }
+  const std::vector<ServiceData> &get_manufacturer_datas() const {
+    this->decode_adv_();
+    return manufacturer_datas_;
+  }
 
-  const std::vector<ServiceData> &get_service_datas() const { return service_datas_; }
+  const std::vector<ServiceData> &get_service_datas() const {
+    this->decode_adv_();
+    return service_datas_;
+  }
 
   const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &get_scan_result() const { return scan_result_; }
 
+  /// The raw AD structures of the advertisement and scan response.
+  AdvDataView get_adv_data() const {
+    return AdvDataView(this->scan_result_.ble_adv, this->scan_result_.adv_data_len + this->scan_result_.scan_rsp_len);
+  }
+
   optional<ESPBLEiBeacon> get_ibeacon() const {
-    for (auto &it : this->manufacturer_datas_) {
+    for (auto &it : this->get_manufacturer_datas()) {
       auto res = ESPBLEiBeacon::from_manufacturer_data(it);
       if (res.has_value())
         return *res;
@@ -90,20 +179,22 @@ class ESPBTDevice {
   }
 
  protected:
-  void parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param);
+  /// Decode the AD structures into the members below, once.
+  void decode_adv_() const;
 
   esp_bd_addr_t address_{
       0,
   };
   esp_ble_addr_type_t address_type_{BLE_ADDR_TYPE_PUBLIC};
   int rssi_{0};
-  std::string name_{};
-  std::vector<int8_t> tx_powers_{};
-  optional<uint16_t> appearance_{};
-  optional<uint8_t> ad_flag_{};
-  std::vector<ESPBTUUID> service_uuids_;
-  std::vector<ServiceData> manufacturer_datas_{};
-  std::vector<ServiceData> service_datas_{};
+  mutable bool adv_decoded_{false};
+  mutable std::string name_{};
+  mutable std::vector<int8_t> tx_powers_{};
+  mutable optional<uint16_t> appearance_{};
+  mutable optional<uint8_t> ad_flag_{};
+  mutable std::vector<ESPBTUUID> service_uuids_;
+  mutable std::vector<ServiceData> manufacturer_datas_{};
+  mutable std::vector<ServiceData> service_datas_{};
   esp_ble_gap_cb_param_t::ble_scan_result_evt_param scan_result_{};
 };
 
@@ -166,13 +257,27 @@ class ESPBTClient : public ESPBTDeviceListener {
   ClientState state_;
 };
 
-class ESP32BLETracker : public Component, public GAPEventHandler, public GATTcEventHandler, public Parented<ESP32BLE> {
+class ESP32BLETracker : public Component,
+                        public GAPEventHandler,
+                        public GAPScanEventHandler,
+                        public GATTcEventHandler,
+                        public Parented<ESP32BLE> {
  public:
   void set_scan_duration(uint32_t scan_duration) { scan_duration_ = scan_duration; }
   void set_scan_interval(uint32_t scan_interval) { scan_interval_ = scan_interval; }
   void set_scan_window(uint32_t scan_window) { scan_window_ = scan_window; }
   void set_scan_active(bool scan_active) { scan_active_ = scan_active; }
   void set_scan_continuous(bool scan_continuous) { scan_continuous_ = scan_continuous; }
+  void set_scan_result_buffer_size(size_t size) { scan_result_buffer_size_ = size; }
+  /// Skip advertisements whose payload didn't change since they were last delivered less than this long ago.
+  void set_dedup_window(uint32_t dedup_window) { dedup_window_ = dedup_window; }
+  /// Number of addresses the dedup window is tracked for, advertisers beyond that are treated as new again.
+  void set_advertisement_cache_size(size_t size) { advertisement_cache_size_ = size; }
+
+  /// Number of advertisements dropped because they arrived faster than the loop could process them.
+  uint32_t get_scan_results_dropped() const { return this->scan_result_ring_.get_dropped(); }
+  /// Number of unchanged advertisements that were not delivered because of the dedup window.
+  uint32_t get_scan_results_deduplicated() const { return this->scan_results_deduplicated_; }
 
   /// Setup the FreeRTOS task and the Bluetooth stack.
   void setup() override;
@@ -181,10 +286,14 @@ class ESP32BLETracker : public Component, public GAPEventHandler, public GATTcEv
 
   void loop() override;
 
-  void register_listener(ESPBTDeviceListener *listener) {
-    listener->set_parent(this);
-    this->listeners_.push_back(listener);
-  }
+  /// Offer every advertisement to the listener.
+  void register_listener(ESPBTDeviceListener *listener);
+  /// Only offer advertisements from the given address to the listener.
+  void register_listener_by_address(ESPBTDeviceListener *listener, uint64_t address);
+  /// Only offer advertisements with manufacturer data of the given company to the listener.
+  void register_listener_by_manufacturer_id(ESPBTDeviceListener *listener, uint16_t manufacturer_id);
+  /// Only offer advertisements that list the given 16-bit service UUID, or carry service data for it, to the listener.
+  void register_listener_by_service_uuid(ESPBTDeviceListener *listener, uint16_t service_uuid);
 
   void register_client(ESPBTClient *client);
 
@@ -196,6 +305,7 @@ class ESP32BLETracker : public Component, public GAPEventHandler, public GATTcEv
   void gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
                            esp_ble_gattc_cb_param_t *param) override;
   void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) override;
+  void gap_scan_event_handler(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) override;
 
  protected:
   /// Start a single scan by setting up the parameters and doing some esp-idf calls.
@@ -204,6 +314,15 @@ class ESP32BLETracker : public Component, public GAPEventHandler, public GATTcEv
   void end_of_scan_();
   /// Called when a `ESP_GAP_BLE_SCAN_RESULT_EVT` event is received.
   void gap_scan_result_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param);
+  /// Hand a batch of queued scan results to the listeners and clients.
+  void process_scan_results_(int connecting, bool &promote_to_connecting);
+  /// Check the scan result against the dedup window, and record it as delivered if it passes.
+  bool should_deliver_(const ScanResultRing::ScanResult &result);
+  void add_listener_(ESPBTDeviceListener *listener);
+  /// Offer the device to the wildcard listeners and the listeners whose filter matches it.
+  bool dispatch_to_listeners_(const ESPBTDevice &device);
+  /// Offer the device to each of the listeners, skipping the ones it was already offered to.
+  bool offer_to_listeners_(const ESPBTDevice &device, const std::vector<ESPBTDeviceListener *> &listeners);
   /// Called when a `ESP_GAP_BLE_SCAN_PARAM_SET_COMPLETE_EVT` event is received.
   void gap_scan_set_param_complete_(const esp_ble_gap_cb_param_t::ble_scan_param_cmpl_evt_param &param);
   /// Called when a `ESP_GAP_BLE_SCAN_START_COMPLETE_EVT` event is received.
@@ -213,9 +332,21 @@ class ESP32BLETracker : public Component, public GAPEventHandler, public GATTcEv
 
   int app_id_;
 
-  /// Vector of addresses that have already been printed in print_bt_device_info
-  std::vector<uint64_t> already_discovered_;
+  /// Recently seen addresses, for the dedup window.
+  AdvertisementCache advertisement_cache_;
+  size_t advertisement_cache_size_{128};
+  /// Addresses print_bt_device_info already logged in this scan, sorted.
+  std::vector<uint64_t> printed_addresses_;
+  uint32_t dedup_window_{0};
+  uint32_t scan_results_deduplicated_{0};
+  /// All listeners, regardless of their filter.
   std::vector<ESPBTDeviceListener *> listeners_;
+  std::vector<ESPBTDeviceListener *> wildcard_listeners_;
+  std::unordered_map<uint64_t, std::vector<ESPBTDeviceListener *>> address_listeners_;
+  std::unordered_map<uint16_t, std::vector<ESPBTDeviceListener *>> manufacturer_listeners_;
+  std::unordered_map<uint16_t, std::vector<ESPBTDeviceListener *>> service_listeners_;
+  /// Filtered listeners the current advertisement was offered to, so none of them sees it twice.
+  std::vector<ESPBTDeviceListener *> offered_listeners_;
   /// Client parameters.
   std::vector<ESPBTClient *> clients_;
   /// A structure holding the ESP BLE scan parameters.
@@ -228,10 +359,13 @@ class ESP32BLETracker : public Component, public GAPEventHandler, public GATTcEv
   bool scan_continuous_;
   bool scan_active_;
   bool scanner_idle_;
-  SemaphoreHandle_t scan_result_lock_;
   SemaphoreHandle_t scan_end_lock_;
-  size_t scan_result_index_{0};
-  esp_ble_gap_cb_param_t::ble_scan_result_evt_param scan_result_buffer_[16];
+  /// Filled by the Bluetooth task, drained by loop().
+  ScanResultRing scan_result_ring_;
+  size_t scan_result_buffer_size_{32};
+  /// Value of the drop counter when the last warning was logged.
+  uint32_t scan_results_dropped_reported_{0};
+  uint32_t scan_results_dropped_warned_{0};
   esp_bt_status_t scan_start_failed_{ESP_BT_STATUS_SUCCESS};
   esp_bt_status_t scan_set_param_failed_{ESP_BT_STATUS_SUCCESS};
 };
@@ -0,0 +1,77 @@
+#pragma once
+
+#ifdef USE_ESP32
+
+#include "esphome/core/helpers.h"
+
+#include <atomic>
+
+#include <esp_gap_ble_api.h>
+
+namespace esphome {
+namespace esp32_ble_tracker {
+
+/** Single producer, single consumer ring of BLE scan results.
+ *
+ * The Bluetooth task pushes advertisements straight from the GAP callback and the main loop pops them, without
+ * either side taking a lock or allocating. The storage is allocated once (in PSRAM if available). When the ring is
+ * full, new results are dropped and counted, as the producer may not touch entries the consumer can see.
+ */
+class ScanResultRing {
+ public:
+  using ScanResult = esp_ble_gap_cb_param_t::ble_scan_result_evt_param;
+
+  /// Allocate room for capacity results, must be called before the Bluetooth stack delivers results.
+  bool init(size_t capacity) {
+    ExternalRAMAllocator<ScanResult> allocator(ExternalRAMAllocator<ScanResult>::ALLOW_FAILURE);
+    // one slot always stays empty to tell a full ring from an empty one
+    this->buffer_ = allocator.allocate(capacity + 1);
+    if (this->buffer_ == nullptr)
+      return false;
+    this->slots_ = capacity + 1;
+    return true;
+  }
+
+  /// Producer side, returns false if the result was dropped.
+  bool push(const ScanResult &result) {
+    const size_t tail = this->tail_.load(std::memory_order_relaxed);
+    const size_t next = this->next_(tail);
+    if (this->buffer_ == nullptr || next == this->head_.load(std::memory_order_acquire)) {
+      this->dropped_.store(this->dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    this->buffer_[tail] = result;
+    this->tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side, the oldest result or nullptr if the ring is empty. Valid until pop().
+  const ScanResult *front() const {
+    const size_t head = this->head_.load(std::memory_order_relaxed);
+    if (head == this->tail_.load(std::memory_order_acquire))
+      return nullptr;
+    return &this->buffer_[head];
+  }
+  /// Consumer side, release the result returned by front().
+  void pop() { this->head_.store(this->next_(this->head_.load(std::memory_order_relaxed)), std::memory_order_release); }
+
+  size_t get_capacity() const { return this->slots_ == 0 ? 0 : this->slots_ - 1; }
+  /// Number of results dropped because the ring was full.
+  uint32_t get_dropped() const { return this->dropped_.load(std::memory_order_relaxed); }
+
+ protected:
+  size_t next_(size_t index) const { return index + 1 == this->slots_ ? 0 : index + 1; }
+
+  ScanResult *buffer_{nullptr};
+  size_t slots_{0};
+  /// Written by the consumer only.
+  std::atomic<size_t> head_{0};
+  /// Written by the producer only.
+  std::atomic<size_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
+
+}  // namespace esp32_ble_tracker
+}  // namespace esphome
+
+#endif
@@ -144,12 +144,18 @@ ARDUINO_FRAMEWORK_SCHEMA = cv.All(
 
 
 BUILD_FLASH_MODES = ["qio", "qout", "dio", "dout"]
+# Flash sectors for the preferences, all but the first are taken from the end of the file
+# system region, so they can only be used if no file system is mounted there.
+CONF_PREFERENCES_SECTORS = "preferences_sectors"
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
             cv.Required(CONF_BOARD): cv.string_strict,
             cv.Optional(CONF_FRAMEWORK, default={}): ARDUINO_FRAMEWORK_SCHEMA,
             cv.Optional(CONF_RESTORE_FROM_FLASH, default=False): cv.boolean,
+            cv.Optional(CONF_PREFERENCES_SECTORS, default=1): cv.int_range(
+                min=1, max=4
+            ),
             cv.Optional(CONF_EARLY_PIN_INIT, default=True): cv.boolean,
             cv.Optional(CONF_BOARD_FLASH_MODE, default="dout"): cv.one_of(
                 *BUILD_FLASH_MODES, lower=True
@@ -199,6 +205,10 @@ async def to_code(config):
 
     if config[CONF_RESTORE_FROM_FLASH]:
         cg.add_define("USE_ESP8266_PREFERENCES_FLASH")
+    if config[CONF_PREFERENCES_SECTORS] > 1:
+        cg.add_define(
+            "USE_ESP8266_PREFERENCES_SECTORS", config[CONF_PREFERENCES_SECTORS]
+        )
 
     if config[CONF_EARLY_PIN_INIT]:
         cg.add_define("USE_ESP8266_EARLY_PIN_INIT")
@@ -11,7 +11,9 @@ extern "C" {
 #include "esphome/core/preferences.h"
 #include "preferences.h"
 
+#include <algorithm>
 #include <cstring>
+#include <utility>
 #include <vector>
 
 namespace esphome {
@@ -34,6 +36,25 @@ static const uint32_t ESP8266_FLASH_STORAGE_SIZE = 128;
 static const uint32_t ESP8266_FLASH_STORAGE_SIZE = 64;
 #endif
 
+/// Words of s_flash_storage that changed since they were last written to flash.
+static uint32_t s_flash_dirty_words[ESP8266_FLASH_STORAGE_SIZE / 32];  // NOLINT
+
+// The flash storage is kept as an append-only log of records, each one holding a range of s_flash_storage:
+//   header word (offset << 16 | length, in words), length data words, FNV-1 hash of header and data
+// A log fills one sector after a header of LOG_MAGIC, its sequence number and the inverted sequence number, the
+// sector with the highest sequence number is the current one. When it is full, the whole storage is written into
+// the next sector as a single record, followed by the sector header to commit it.
+static const uint32_t LOG_MAGIC = 0x45504C47;
+static const uint32_t LOG_SECTOR_HEADER_WORDS = 3;
+static const uint32_t LOG_SECTOR_WORDS = SPI_FLASH_SEC_SIZE / 4;
+static const uint32_t LOG_MAX_SECTORS = 4;
+#ifndef USE_ESP8266_PREFERENCES_SECTORS
+#define USE_ESP8266_PREFERENCES_SECTORS 1
+#endif
+/// Runs of changed words closer than this are written as one record, which is cheaper than two.
+static const uint32_t LOG_MAX_GAP_WORDS = 2;
+static const uint32_t LOG_ERASED = 0xFFFFFFFF;
+
 static inline bool esp_rtc_user_mem_read(uint32_t index, uint32_t *dest) {
   if (index >= ESP_RTC_USER_MEM_SIZE_WORDS) {
     return false;
@@ -55,7 +76,8 @@ static inline bool esp_rtc_user_mem_write(uint32_t index, uint32_t value) {
   return true;
 }
 
-extern "C" uint32_t _SPIFFS_end;  // NOLINT
+extern "C" uint32_t _SPIFFS_start;  // NOLINT
+extern "C" uint32_t _SPIFFS_end;    // NOLINT
 
 static uint32_t get_esp8266_flash_sector() {
   union {
@@ -67,6 +89,15 @@ static uint32_t get_esp8266_flash_sector() {
 }
 static uint32_t get_esp8266_flash_address() { return get_esp8266_flash_sector() * SPI_FLASH_SEC_SIZE; }
 
+/// The sector after the file system, which always held the preferences, plus the sectors at the end of the file
+/// system region that were given to the preferences with the preferences_sectors option, as far as there are any.
+static uint32_t get_esp8266_flash_sector_count() {
+  const uint32_t fs_sectors =
+      (reinterpret_cast<uintptr_t>(&_SPIFFS_end) - reinterpret_cast<uintptr_t>(&_SPIFFS_start)) / SPI_FLASH_SEC_SIZE;
+  const uint32_t configured = std::min<uint32_t>(USE_ESP8266_PREFERENCES_SECTORS, LOG_MAX_SECTORS);
+  return 1 + std::min(fs_sectors, configured - 1);
+}
+
 template<class It> uint32_t calculate_crc(It first, It last, uint32_t type) {
   uint32_t crc = type;
   while (first != last) {
@@ -82,13 +113,17 @@ static bool save_to_flash(size_t offset, const uint32_t *data, size_t len) {
       return false;
     uint32_t v = data[i];
     uint32_t *ptr = &s_flash_storage[j];
-    if (*ptr != v)
+    if (*ptr != v) {
       s_flash_dirty = true;
+      s_flash_dirty_words[j / 32] |= 1u << (j % 32);
+    }
     *ptr = v;
   }
   return true;
 }
 
+static bool is_word_dirty(uint32_t index) { return (s_flash_dirty_words[index / 32] & (1u << (index % 32))) != 0; }
+
 static bool load_from_flash(size_t offset, uint32_t *data, size_t len) {
   for (size_t i = 0; i < len; i++) {
     uint32_t j = offset + i;
@@ -171,9 +206,32 @@ class ESP8266Preferences : public ESPPreferences {
     s_flash_storage = new uint32_t[ESP8266_FLASH_STORAGE_SIZE];  // NOLINT
     ESP_LOGVV(TAG, "Loading preferences from flash...");
 
-    {
-      InterruptLock lock;
-      spi_flash_read(get_esp8266_flash_address(), s_flash_storage, ESP8266_FLASH_STORAGE_SIZE * 4);
+    this->sector_count_ = get_esp8266_flash_sector_count();
+    bool found = false;
+    for (uint32_t i = 0; i < this->sector_count_; i++) {
+      uint32_t header[LOG_SECTOR_HEADER_WORDS];
+      this->read_(i, 0, header, LOG_SECTOR_HEADER_WORDS);
+      if (header[0] != LOG_MAGIC || header[1] != ~header[2])
+        continue;
+      if (!found || static_cast<int32_t>(header[1] - this->sequence_) > 0) {
+        this->active_ = i;
+        this->sequence_ = header[1];
+        found = true;
+      }
+    }
+
+    if (!found) {
+      // no log yet, the sector holds the storage as a plain array like before
+      this->read_(0, 0, s_flash_storage, ESP8266_FLASH_STORAGE_SIZE);
+      this->mark_all_dirty_();
+      this->needs_compaction_ = true;
+      return;
+    }
+    memset(s_flash_storage, 0xFF, ESP8266_FLASH_STORAGE_SIZE * 4);
+    this->replay_();
+    for (uint32_t i = 0; i < this->sector_count_; i++) {
+      if (i != this->active_)
+        this->erased_[i] = this->is_erased_(i);
     }
   }
 
@@ -230,49 +288,196 @@ class ESP8266Preferences : public ESPPreferences {
   }
 
   bool sync() override {
-    if (!s_flash_dirty)
-      return true;
     if (s_prevent_write)
-      return false;
+      return !s_flash_dirty;
+    if (!s_flash_dirty) {
+      // erase a sector that is no longer used while nothing else is written, so compacting doesn't have to
+      for (uint32_t i = 0; i < this->sector_count_; i++) {
+        if (i != this->active_ && !this->erased_[i])
+          return this->erase_(i);
+      }
+      return true;
+    }
 
     ESP_LOGD(TAG, "Saving preferences to flash...");
-    SpiFlashOpResult erase_res, write_res = SPI_FLASH_RESULT_OK;
+    bool ok = this->needs_compaction_ ? this->compact_() : this->append_();
+    if (ok) {
+      memset(s_flash_dirty_words, 0, sizeof(s_flash_dirty_words));
+      s_flash_dirty = false;
+    }
+    return ok;
+  }
+
+  bool reset() override {
+    ESP_LOGD(TAG, "Cleaning up preferences in flash...");
+    for (uint32_t i = 0; i < this->sector_count_; i++) {
+      if (!this->erase_(i))
+        return false;
+    }
+
+    // Protect flash from writing till restart
+    s_prevent_write = true;
+    return true;
+  }
+
+ protected:
+  static uint32_t sector_address_(uint32_t sector) {
+    return (get_esp8266_flash_sector() - sector) * SPI_FLASH_SEC_SIZE;
+  }
+
+  void read_(uint32_t sector, uint32_t offset, uint32_t *data, uint32_t len) {
+    InterruptLock lock;
+    spi_flash_read(sector_address_(sector) + offset * 4, data, len * 4);
+  }
+
+  bool write_(uint32_t sector, uint32_t offset, uint32_t *data, uint32_t len) {
+    SpiFlashOpResult res;
     {
       InterruptLock lock;
-      erase_res = spi_flash_erase_sector(get_esp8266_flash_sector());
-      if (erase_res == SPI_FLASH_RESULT_OK) {
-        write_res = spi_flash_write(get_esp8266_flash_address(), s_flash_storage, ESP8266_FLASH_STORAGE_SIZE * 4);
-      }
-    }
-    if (erase_res != SPI_FLASH_RESULT_OK) {
-      ESP_LOGE(TAG, "Erase ESP8266 flash failed!");
-      return false;
+      res = spi_flash_write(sector_address_(sector) + offset * 4, data, len * 4);
     }
-    if (write_res != SPI_FLASH_RESULT_OK) {
+    this->erased_[sector] = false;
+    if (res != SPI_FLASH_RESULT_OK) {
       ESP_LOGE(TAG, "Write ESP8266 flash failed!");
+      // the log may be broken from here on, start over in another sector
+      this->needs_compaction_ = true;
       return false;
     }
-
-    s_flash_dirty = false;
     return true;
   }
 
-  bool reset() override {
-    ESP_LOGD(TAG, "Cleaning up preferences in flash...");
-    SpiFlashOpResult erase_res;
+  bool erase_(uint32_t sector) {
+    SpiFlashOpResult res;
     {
       InterruptLock lock;
-      erase_res = spi_flash_erase_sector(get_esp8266_flash_sector());
+      res = spi_flash_erase_sector(get_esp8266_flash_sector() - sector);
     }
-    if (erase_res != SPI_FLASH_RESULT_OK) {
+    if (res != SPI_FLASH_RESULT_OK) {
       ESP_LOGE(TAG, "Erase ESP8266 flash failed!");
       return false;
     }
+    this->erased_[sector] = true;
+    return true;
+  }
 
-    // Protect flash from writing till restart
-    s_prevent_write = true;
+  bool is_erased_(uint32_t sector) {
+    uint32_t chunk[32];
+    for (uint32_t pos = 0; pos < LOG_SECTOR_WORDS; pos += 32) {
+      this->read_(sector, pos, chunk, 32);
+      for (uint32_t word : chunk) {
+        if (word != LOG_ERASED)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  void mark_all_dirty_() {
+    for (uint32_t i = 0; i < ESP8266_FLASH_STORAGE_SIZE; i++)
+      s_flash_dirty_words[i / 32] |= 1u << (i % 32);
+    s_flash_dirty = true;
+  }
+
+  /// Apply the records of the current sector to s_flash_storage.
+  void replay_() {
+    std::vector<uint32_t> record(ESP8266_FLASH_STORAGE_SIZE + 2);
+    uint32_t pos = LOG_SECTOR_HEADER_WORDS;
+    while (pos < LOG_SECTOR_WORDS) {
+      this->read_(this->active_, pos, record.data(), 1);
+      if (record[0] == LOG_ERASED)
+        break;
+      const uint32_t offset = record[0] >> 16;
+      const uint32_t len = record[0] & 0xFFFF;
+      if (len == 0 || offset + len > ESP8266_FLASH_STORAGE_SIZE || pos + len + 2 > LOG_SECTOR_WORDS) {
+        ESP_LOGW(TAG, "Invalid preferences record at word %u", pos);
+        this->needs_compaction_ = true;
+        break;
+      }
+      this->read_(this->active_, pos + 1, record.data() + 1, len + 1);
+      if (fnv1_hash(reinterpret_cast<uint8_t *>(record.data()), (len + 1) * 4) != record[len + 1]) {
+        // most likely the write was interrupted by a reset, the records before are fine
+        ESP_LOGW(TAG, "Corrupted preferences record at word %u", pos);
+        this->needs_compaction_ = true;
+        break;
+      }
+      memcpy(s_flash_storage + offset, record.data() + 1, len * 4);
+      pos += len + 2;
+    }
+    this->write_pos_ = pos;
+    ESP_LOGV(TAG, "Loaded preferences from sector %u, %u of %u words used", this->active_, pos, LOG_SECTOR_WORDS);
+  }
+
+  /// Write a record for every run of changed words at the end of the current sector.
+  bool append_() {
+    // collect the runs first, so a log that doesn't have room for all of them is compacted instead
+    std::vector<std::pair<uint32_t, uint32_t>> runs;
+    uint32_t needed = 0;
+    for (uint32_t i = 0; i < ESP8266_FLASH_STORAGE_SIZE; i++) {
+      if (!is_word_dirty(i))
+        continue;
+      if (!runs.empty() && i - (runs.back().first + runs.back().second) <= LOG_MAX_GAP_WORDS) {
+        needed += i + 1 - (runs.back().first + runs.back().second);
+        runs.back().second = i + 1 - runs.back().first;
+      } else {
+        runs.emplace_back(i, 1);
+        needed += 3;
+      }
+    }
+    if (this->write_pos_ + needed > LOG_SECTOR_WORDS)
+      return this->compact_();
+
+    std::vector<uint32_t> record;
+    for (auto &run : runs) {
+      if (!this->write_record_(run.first, run.second, &record))
+        return false;
+    }
+    return true;
+  }
+
+  bool write_record_(uint32_t offset, uint32_t len, std::vector<uint32_t> *record) {
+    record->resize(len + 2);
+    (*record)[0] = (offset << 16) | len;
+    memcpy(record->data() + 1, s_flash_storage + offset, len * 4);
+    (*record)[len + 1] = fnv1_hash(reinterpret_cast<uint8_t *>(record->data()), (len + 1) * 4);
+    if (!this->write_(this->active_, this->write_pos_, record->data(), len + 2))
+      return false;
+    this->write_pos_ += len + 2;
     return true;
   }
+
+  /// Write the whole storage into the next sector and make that the current one.
+  bool compact_() {
+    const uint32_t target = (this->active_ + 1) % this->sector_count_;
+    ESP_LOGD(TAG, "Compacting preferences into sector %u", target);
+    if (!this->erased_[target] && !this->erase_(target))
+      return false;
+
+    const uint32_t previous = this->active_;
+    this->active_ = target;
+    this->write_pos_ = LOG_SECTOR_HEADER_WORDS;
+    std::vector<uint32_t> record;
+    if (!this->write_record_(0, ESP8266_FLASH_STORAGE_SIZE, &record))
+      return false;
+    // the header goes last, until it's written the previous sector stays the current one after a reset
+    uint32_t header[LOG_SECTOR_HEADER_WORDS] = {LOG_MAGIC, this->sequence_ + 1, ~(this->sequence_ + 1)};
+    if (!this->write_(target, 0, header, LOG_SECTOR_HEADER_WORDS))
+      return false;
+    this->sequence_++;
+    this->needs_compaction_ = false;
+    if (previous != target)
+      this->erased_[previous] = false;
+    return true;
+  }
+
+  uint32_t sector_count_{1};
+  /// Index of the current sector, counting down from the sector after the file system.
+  uint32_t active_{0};
+  uint32_t sequence_{0};
+  /// Next free word in the current sector.
+  uint32_t write_pos_{LOG_SECTOR_WORDS};
+  bool needs_compaction_{false};
+  /// Whether a sector is known to be erased, so compacting into it doesn't have to erase it first.
+  bool erased_[LOG_MAX_SECTORS]{};
 };
 
 void setup_preferences() {
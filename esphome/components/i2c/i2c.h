@@ -53,6 +53,15 @@ class I2CDevice {
     return this->read(data, len);
   }
 
+  /// Queue a read that doesn't block the main loop, see I2CBus::submit().
+  void read_async(uint8_t *data, size_t len, TransactionCallback &&callback) {
+    bus_->submit(address_, nullptr, 0, data, len, std::move(callback));
+  }
+  /// Queue a register read that doesn't block the main loop, see I2CBus::submit().
+  void read_register_async(uint8_t a_register, uint8_t *data, size_t len, TransactionCallback &&callback) {
+    bus_->submit(address_, &a_register, 1, data, len, std::move(callback));
+  }
+
   ErrorCode write(const uint8_t *data, uint8_t len, bool stop = true) { return bus_->write(address_, data, len, stop); }
   ErrorCode write_register(uint8_t a_register, const uint8_t *data, size_t len, bool stop = true) {
     WriteBuffer buffers[2];
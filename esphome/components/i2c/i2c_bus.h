@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,9 @@ struct WriteBuffer {
   size_t len;
 };
 
+/// Called with the result of a queued transaction.
+using TransactionCallback = std::function<void(ErrorCode)>;
+
 class I2CBus {
  public:
   virtual ErrorCode read(uint8_t address, uint8_t *buffer, size_t len) {
@@ -50,6 +54,22 @@ class I2CBus {
   }
   virtual ErrorCode writev(uint8_t address, WriteBuffer *buffers, size_t cnt, bool stop) = 0;
 
+  /** Queue a transaction: a write of write_len bytes followed by a read of read_len bytes with a repeated start.
+   *
+   * The callback is called from the main loop once the transaction is done. The written data is copied, read_data
+   * has to stay valid until the callback was called. Buses without a transaction queue perform the transaction
+   * right away and call the callback before returning.
+   */
+  virtual void submit(uint8_t address, const uint8_t *write_data, size_t write_len, uint8_t *read_data,
+                      size_t read_len, TransactionCallback &&callback) {
+    ErrorCode err = ERROR_OK;
+    if (write_len > 0)
+      err = this->write(address, write_data, write_len, read_len == 0);
+    if (err == ERROR_OK && read_len > 0)
+      err = this->read(address, read_data, read_len);
+    callback(err);
+  }
+
  protected:
   void i2c_scan_() {
     for (uint8_t address = 8; address < 120; address++) {
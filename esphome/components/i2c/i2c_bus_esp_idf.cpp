@@ -4,6 +4,7 @@
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
+#include <algorithm>
 #include <cstring>
 
 namespace esphome {
@@ -11,6 +12,9 @@ namespace i2c {
 
 static const char *const TAG = "i2c.idf";
 
+/// Transactions that may be queued at once, further ones are performed right away.
+static const size_t MAX_QUEUED_TRANSACTIONS = 16;
+
 void IDFI2CBus::setup() {
   static i2c_port_t next_port = 0;
   port_ = next_port++;
@@ -37,11 +41,17 @@ void IDFI2CBus::setup() {
     this->mark_failed();
     return;
   }
+  // also guards the transaction statistics, which are kept for the blocking calls as well
+  this->lock_ = xSemaphoreCreateMutex();
+  this->bus_lock_ = xSemaphoreCreateMutex();
   initialized_ = true;
   if (this->scan_) {
     ESP_LOGV(TAG, "Scanning i2c bus for active devices...");
     this->i2c_scan_();
   }
+#ifdef ESPHOME_LOG_HAS_VERBOSE
+  this->set_interval("stats", 60000, [this]() { this->log_stats_(); });
+#endif
 }
 void IDFI2CBus::dump_config() {
   ESP_LOGCONFIG(TAG, "I2C Bus:");
@@ -76,6 +86,34 @@ void IDFI2CBus::dump_config() {
 }
 
 ErrorCode IDFI2CBus::readv(uint8_t address, ReadBuffer *buffers, size_t cnt) {
+  this->acquire_bus_();
+  ErrorCode err = this->readv_(address, buffers, cnt);
+  this->release_bus_(true, err);
+  return err;
+}
+ErrorCode IDFI2CBus::writev(uint8_t address, WriteBuffer *buffers, size_t cnt, bool stop) {
+  this->acquire_bus_();
+  ErrorCode err = this->writev_(address, buffers, cnt);
+  this->release_bus_(stop, err);
+  return err;
+}
+
+void IDFI2CBus::acquire_bus_() {
+  if (this->bus_lock_ == nullptr || this->bus_held_)
+    return;
+  xSemaphoreTake(this->bus_lock_, portMAX_DELAY);
+  this->bus_held_ = true;
+}
+
+void IDFI2CBus::release_bus_(bool stop, ErrorCode result) {
+  // a failed write without stop isn't followed by the read, so it mustn't keep the bus either
+  if (!this->bus_held_ || (!stop && result == ERROR_OK))
+    return;
+  this->bus_held_ = false;
+  xSemaphoreGive(this->bus_lock_);
+}
+
+ErrorCode IDFI2CBus::readv_(uint8_t address, ReadBuffer *buffers, size_t cnt) {
   // logging is only enabled with vv level, if warnings are shown the caller
   // should log them
   if (!initialized_) {
@@ -112,7 +150,7 @@ ErrorCode IDFI2CBus::readv(uint8_t address, ReadBuffer *buffers, size_t cnt) {
     i2c_cmd_link_delete(cmd);
     return ERROR_UNKNOWN;
   }
-  err = i2c_master_cmd_begin(port_, cmd, 20 / portTICK_PERIOD_MS);
+  err = this->execute_(address, cmd);
   i2c_cmd_link_delete(cmd);
   if (err == ESP_FAIL) {
     // transfer not acked
@@ -142,7 +180,7 @@ ErrorCode IDFI2CBus::readv(uint8_t address, ReadBuffer *buffers, size_t cnt) {
 
   return ERROR_OK;
 }
-ErrorCode IDFI2CBus::writev(uint8_t address, WriteBuffer *buffers, size_t cnt, bool stop) {
+ErrorCode IDFI2CBus::writev_(uint8_t address, WriteBuffer *buffers, size_t cnt) {
   // logging is only enabled with vv level, if warnings are shown the caller
   // should log them
   if (!initialized_) {
@@ -194,7 +232,7 @@ ErrorCode IDFI2CBus::writev(uint8_t address, WriteBuffer *buffers, size_t cnt, b
     i2c_cmd_link_delete(cmd);
     return ERROR_UNKNOWN;
   }
-  err = i2c_master_cmd_begin(port_, cmd, 20 / portTICK_PERIOD_MS);
+  err = this->execute_(address, cmd);
   i2c_cmd_link_delete(cmd);
   if (err == ESP_FAIL) {
     // transfer not acked
@@ -210,6 +248,165 @@ ErrorCode IDFI2CBus::writev(uint8_t address, WriteBuffer *buffers, size_t cnt, b
   return ERROR_OK;
 }
 
+void IDFI2CBus::loop() {
+  if (this->in_flight_.load() == 0)
+    return;
+  Transaction *done;
+  while (xQueueReceive(this->completed_, &done, 0) == pdTRUE) {
+    std::unique_ptr<Transaction> transaction(done);
+    this->in_flight_--;
+    transaction->callback(transaction->result);
+  }
+}
+
+void IDFI2CBus::submit(uint8_t address, const uint8_t *write_data, size_t write_len, uint8_t *read_data,
+                       size_t read_len, TransactionCallback &&callback) {
+  if (!initialized_) {
+    callback(ERROR_NOT_INITIALIZED);
+    return;
+  }
+  if ((this->worker_ == nullptr && !this->start_worker_()) || this->in_flight_.load() >= MAX_QUEUED_TRANSACTIONS) {
+    I2CBus::submit(address, write_data, write_len, read_data, read_len, std::move(callback));
+    return;
+  }
+
+  auto transaction = make_unique<Transaction>();
+  transaction->address = address;
+  transaction->write_data.assign(write_data, write_data + write_len);
+  transaction->read_data = read_data;
+  transaction->read_len = read_len;
+  transaction->callback = std::move(callback);
+  this->in_flight_++;
+  xSemaphoreTake(this->lock_, portMAX_DELAY);
+  this->pending_.push_back(std::move(transaction));
+  xSemaphoreGive(this->lock_);
+  xTaskNotifyGive(this->worker_);
+}
+
+bool IDFI2CBus::start_worker_() {
+  // room for every transaction that can be in flight, so the worker never waits for the main loop
+  if (this->completed_ == nullptr)
+    this->completed_ = xQueueCreate(MAX_QUEUED_TRANSACTIONS, sizeof(Transaction *));
+  if (this->lock_ == nullptr || this->bus_lock_ == nullptr || this->completed_ == nullptr) {
+    ESP_LOGW(TAG, "Could not create the transaction queue");
+    return false;
+  }
+  // same priority as the loop task, it spends most of its time waiting for the bus anyway
+  if (xTaskCreate(IDFI2CBus::worker_task, "i2c_worker", 3072, this, 1, &this->worker_) != pdPASS) {
+    ESP_LOGW(TAG, "Could not start the transaction worker");
+    this->worker_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void IDFI2CBus::worker_task(void *param) {
+  auto *bus = reinterpret_cast<IDFI2CBus *>(param);
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (true) {
+      xSemaphoreTake(bus->lock_, portMAX_DELAY);
+      std::unique_ptr<Transaction> transaction = bus->next_transaction_();
+      xSemaphoreGive(bus->lock_);
+      if (transaction == nullptr)
+        break;
+      xSemaphoreTake(bus->bus_lock_, portMAX_DELAY);
+      transaction->result = bus->transact_(transaction->address, transaction->write_data.data(),
+                                           transaction->write_data.size(), transaction->read_data,
+                                           transaction->read_len);
+      xSemaphoreGive(bus->bus_lock_);
+      Transaction *done = transaction.release();
+      xQueueSend(bus->completed_, &done, portMAX_DELAY);
+    }
+  }
+}
+
+std::unique_ptr<IDFI2CBus::Transaction> IDFI2CBus::next_transaction_() {
+  if (this->pending_.empty())
+    return nullptr;
+  // the oldest transaction of the device with the next address after the last served one, so a device that
+  // queues a lot can't starve the others
+  auto next = this->pending_.begin();
+  uint8_t next_distance = (*next)->address - this->last_address_ - 1;
+  for (auto it = next + 1; it != this->pending_.end(); ++it) {
+    const uint8_t distance = (*it)->address - this->last_address_ - 1;
+    if (distance < next_distance) {
+      next = it;
+      next_distance = distance;
+    }
+  }
+  std::unique_ptr<Transaction> transaction = std::move(*next);
+  this->pending_.erase(next);
+  this->last_address_ = transaction->address;
+  return transaction;
+}
+
+ErrorCode IDFI2CBus::transact_(uint8_t address, const uint8_t *write_data, size_t write_len, uint8_t *read_data,
+                               size_t read_len) {
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+  esp_err_t err = i2c_master_start(cmd);
+  if (err == ESP_OK && write_len > 0) {
+    err = i2c_master_write_byte(cmd, (address << 1) | I2C_MASTER_WRITE, true);
+    if (err == ESP_OK)
+      err = i2c_master_write(cmd, write_data, write_len, true);
+    if (err == ESP_OK && read_len > 0)
+      err = i2c_master_start(cmd);
+  }
+  if (err == ESP_OK && read_len > 0) {
+    err = i2c_master_write_byte(cmd, (address << 1) | I2C_MASTER_READ, true);
+    if (err == ESP_OK)
+      err = i2c_master_read(cmd, read_data, read_len, I2C_MASTER_LAST_NACK);
+  }
+  if (err == ESP_OK)
+    err = i2c_master_stop(cmd);
+  if (err != ESP_OK) {
+    ESP_LOGVV(TAG, "Transaction with %02X could not be built: %s", address, esp_err_to_name(err));
+    i2c_cmd_link_delete(cmd);
+    return ERROR_UNKNOWN;
+  }
+  err = this->execute_(address, cmd);
+  i2c_cmd_link_delete(cmd);
+  if (err == ESP_FAIL)
+    return ERROR_NOT_ACKNOWLEDGED;
+  if (err == ESP_ERR_TIMEOUT)
+    return ERROR_TIMEOUT;
+  return err == ESP_OK ? ERROR_OK : ERROR_UNKNOWN;
+}
+
+esp_err_t IDFI2CBus::execute_(uint8_t address, i2c_cmd_handle_t cmd) {
+  // the caller holds bus_lock_, so the timeout is only spent on this transfer and not waiting for the driver
+  const uint32_t started = micros();
+  esp_err_t err = i2c_master_cmd_begin(port_, cmd, 20 / portTICK_PERIOD_MS);
+  const uint32_t duration = micros() - started;
+  if (this->lock_ == nullptr)
+    return err;
+
+  xSemaphoreTake(this->lock_, portMAX_DELAY);
+  auto it = this->stats_.begin();
+  while (it != this->stats_.end() && it->address != address)
+    ++it;
+  if (it == this->stats_.end())
+    it = this->stats_.insert(it, DeviceStats{address, 0, 0, 0, 0});
+  it->count++;
+  if (err != ESP_OK)
+    it->errors++;
+  it->total_us += duration;
+  it->max_us = std::max(it->max_us, duration);
+  xSemaphoreGive(this->lock_);
+  return err;
+}
+
+void IDFI2CBus::log_stats_() {
+  if (this->lock_ == nullptr)
+    return;
+  xSemaphoreTake(this->lock_, portMAX_DELAY);
+  for (const auto &stats : this->stats_) {
+    ESP_LOGV(TAG, "0x%02X: %u transactions, %u failed, %u us on average, %u us at most", stats.address, stats.count,
+             stats.errors, static_cast<uint32_t>(stats.total_us / stats.count), stats.max_us);
+  }
+  xSemaphoreGive(this->lock_);
+}
+
 /// Perform I2C bus recovery, see:
 /// https://www.nxp.com/docs/en/user-guide/UM10204.pdf
 /// https://www.analog.com/media/en/technical-documentation/application-notes/54305147357414AN686_0.pdf
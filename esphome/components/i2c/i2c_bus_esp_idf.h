@@ -5,6 +5,14 @@
 #include "i2c_bus.h"
 #include "esphome/core/component.h"
 #include <driver/i2c.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
 
 namespace esphome {
 namespace i2c {
@@ -19,8 +27,14 @@ class IDFI2CBus : public I2CBus, public Component {
  public:
   void setup() override;
   void dump_config() override;
+  /// Call the callbacks of completed transactions.
+  void loop() override;
+  /// Blocking calls share the bus with the worker, a write without stop keeps it until the next call is done.
   ErrorCode readv(uint8_t address, ReadBuffer *buffers, size_t cnt) override;
   ErrorCode writev(uint8_t address, WriteBuffer *buffers, size_t cnt, bool stop) override;
+  /// Transactions are performed by a worker task, so the main loop doesn't wait for the bus.
+  void submit(uint8_t address, const uint8_t *write_data, size_t write_len, uint8_t *read_data, size_t read_len,
+              TransactionCallback &&callback) override;
   float get_setup_priority() const override { return setup_priority::BUS; }
 
   void set_scan(bool scan) { scan_ = scan; }
@@ -35,6 +49,38 @@ class IDFI2CBus : public I2CBus, public Component {
   RecoveryCode recovery_result_;
 
  protected:
+  struct Transaction {
+    uint8_t address;
+    std::vector<uint8_t> write_data;
+    uint8_t *read_data;
+    size_t read_len;
+    TransactionCallback callback;
+    ErrorCode result;
+  };
+  struct DeviceStats {
+    uint8_t address;
+    uint32_t count;
+    uint32_t errors;
+    uint64_t total_us;
+    uint32_t max_us;
+  };
+
+  ErrorCode readv_(uint8_t address, ReadBuffer *buffers, size_t cnt);
+  ErrorCode writev_(uint8_t address, WriteBuffer *buffers, size_t cnt);
+  /// Take the bus for a blocking call, unless a previous write without stop still holds it.
+  void acquire_bus_();
+  /// Give the bus back, unless this was a successful write without stop that the next call continues.
+  void release_bus_(bool stop, ErrorCode result);
+  bool start_worker_();
+  static void worker_task(void *param);
+  /// Take the next transaction, going round robin between the devices with queued transactions. Needs lock_.
+  std::unique_ptr<Transaction> next_transaction_();
+  ErrorCode transact_(uint8_t address, const uint8_t *write_data, size_t write_len, uint8_t *read_data,
+                      size_t read_len);
+  /// Run a command link and record how long the bus was busy with it.
+  esp_err_t execute_(uint8_t address, i2c_cmd_handle_t cmd);
+  void log_stats_();
+
   i2c_port_t port_;
   uint8_t sda_pin_;
   bool sda_pullup_enabled_;
@@ -42,6 +88,18 @@ class IDFI2CBus : public I2CBus, public Component {
   bool scl_pullup_enabled_;
   uint32_t frequency_;
   bool initialized_ = false;
+
+  SemaphoreHandle_t lock_{nullptr};
+  /// Held for every transfer, so a queued transaction can't get between a write without stop and the read after it.
+  SemaphoreHandle_t bus_lock_{nullptr};
+  bool bus_held_{false};  // only used by the blocking calls, which all come from the main loop
+  TaskHandle_t worker_{nullptr};
+  QueueHandle_t completed_{nullptr};
+  /// Transactions that were submitted and whose callback wasn't called yet.
+  std::atomic<size_t> in_flight_{0};
+  std::deque<std::unique_ptr<Transaction>> pending_;  // guarded by lock_
+  uint8_t last_address_{0};                            // guarded by lock_
+  std::vector<DeviceStats> stats_;                     // guarded by lock_
 };
 
 }  // namespace i2c
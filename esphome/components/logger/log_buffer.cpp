@@ -0,0 +1,134 @@
+#include "log_buffer.h"
+
+#include "esphome/core/helpers.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace logger {
+
+static const uint8_t FLAG_COMMITTED = 1 << 0;
+static const uint8_t FLAG_WRAP = 1 << 1;
+
+LogBuffer::LogBuffer(size_t capacity) : capacity_(capacity & ~(alignof(Header) - 1)) {
+  ExternalRAMAllocator<uint8_t> allocator(ExternalRAMAllocator<uint8_t>::ALLOW_FAILURE);
+  this->buffer_ = allocator.allocate(this->capacity_);
+  if (this->buffer_ == nullptr)
+    this->capacity_ = 0;
+}
+
+char *LogBuffer::acquire(uint8_t level, const char *tag, uint16_t length) {
+  const size_t size = record_size_(length);
+  size_t offset;
+  Header *header;
+  {
+    Lock lock(this);
+    if (!this->reserve_(size, &offset)) {
+      this->dropped_ = this->dropped_ + 1;
+      return nullptr;
+    }
+    header = this->header_at_(offset);
+    header->tag = tag;
+    header->length = length;
+    header->level = level;
+    header->flags = 0;
+    this->tail_ = offset + size;
+    this->records_++;
+  }
+  return reinterpret_cast<char *>(header + 1);
+}
+
+void LogBuffer::commit(char *message) {
+  Header *header = reinterpret_cast<Header *>(message) - 1;
+  __atomic_store_n(&header->flags, FLAG_COMMITTED, __ATOMIC_RELEASE);
+}
+
+bool LogBuffer::front(uint8_t *level, const char **tag, const char **message, uint16_t *length) {
+  Header *header;
+  {
+    Lock lock(this);
+    if (this->records_ == 0)
+      return false;
+    // records are only ever removed by the reader, so the head record stays valid after unlocking
+    header = this->header_at_(this->head_);
+  }
+  if ((__atomic_load_n(&header->flags, __ATOMIC_ACQUIRE) & FLAG_COMMITTED) == 0)
+    return false;
+  *level = header->level;
+  *tag = header->tag;
+  *message = reinterpret_cast<const char *>(header + 1);
+  *length = header->length;
+  return true;
+}
+
+void LogBuffer::pop() {
+  Lock lock(this);
+  if (this->records_ == 0)
+    return;
+  const Header *header = this->header_at_(this->head_);
+  this->head_ = this->resolve_(this->head_ + record_size_(header->length));
+  this->records_--;
+  if (this->records_ == 0)
+    this->head_ = this->tail_ = 0;
+}
+
+#ifdef USE_ESP32
+LogBuffer::Lock::Lock(LogBuffer *buffer) : mux_(&buffer->mux_) {
+  if (xPortInIsrContext()) {
+    portENTER_CRITICAL_ISR(this->mux_);
+  } else {
+    portENTER_CRITICAL(this->mux_);
+  }
+}
+LogBuffer::Lock::~Lock() {
+  if (xPortInIsrContext()) {
+    portEXIT_CRITICAL_ISR(this->mux_);
+  } else {
+    portEXIT_CRITICAL(this->mux_);
+  }
+}
+#else
+LogBuffer::Lock::Lock(LogBuffer *buffer) {}
+LogBuffer::Lock::~Lock() {}
+#endif
+
+size_t LogBuffer::resolve_(size_t offset) {
+  if (this->capacity_ - offset < sizeof(Header))
+    return 0;
+  if ((this->header_at_(offset)->flags & FLAG_WRAP) != 0)
+    return 0;
+  return offset;
+}
+
+bool LogBuffer::reserve_(size_t size, size_t *offset) {
+  if (this->records_ == 0) {
+    this->head_ = this->tail_ = 0;
+    *offset = 0;
+    return size <= this->capacity_;
+  }
+
+  if (this->tail_ > this->head_) {
+    if (this->capacity_ - this->tail_ >= size) {
+      *offset = this->tail_;
+      return true;
+    }
+    if (this->head_ >= size) {
+      // continue at the start of the ring, tell the reader to do the same
+      if (this->capacity_ - this->tail_ >= sizeof(Header))
+        this->header_at_(this->tail_)->flags = FLAG_WRAP;
+      *offset = 0;
+      return true;
+    }
+    return false;
+  }
+
+  if (this->tail_ < this->head_ && this->head_ - this->tail_ >= size) {
+    *offset = this->tail_;
+    return true;
+  }
+  // tail_ == head_ with records in the ring means it's full
+  return false;
+}
+
+}  // namespace logger
+}  // namespace esphome
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "esphome/core/helpers.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#endif
+
+namespace esphome {
+namespace logger {
+
+/** Bounded FIFO of formatted log messages, written from any task and drained by the logger's loop().
+ *
+ * Messages are stored back to back in a single byte ring that is allocated once (in PSRAM if available). Writers
+ * reserve room for a message with acquire(), fill it in without holding any lock and publish it with commit(), so a
+ * slow writer never blocks the others for longer than the bookkeeping takes. The reader only sees messages in order
+ * and stops at the first one that is not committed yet. When the ring is full, new messages are dropped and counted.
+ */
+class LogBuffer {
+ public:
+  explicit LogBuffer(size_t capacity);
+
+  /// Reserve room for a message of length characters and a null terminator, returns nullptr if the ring is full.
+  char *acquire(uint8_t level, const char *tag, uint16_t length);
+  /// Publish a message returned by acquire().
+  void commit(char *message);
+
+  /// The oldest message, returns false if there is none or it is still being written. Valid until pop().
+  bool front(uint8_t *level, const char **tag, const char **message, uint16_t *length);
+  /// Remove the message returned by front().
+  void pop();
+
+  size_t get_capacity() const { return this->capacity_; }
+  /// Number of messages dropped because the ring was full.
+  uint32_t get_dropped() const { return this->dropped_; }
+
+ protected:
+  struct Header {
+    const char *tag;
+    uint16_t length;  ///< Excluding the null terminator.
+    uint8_t level;
+    uint8_t flags;
+  };
+
+  /// Guards the bookkeeping of the ring, the messages themselves are written outside of it.
+  class Lock {
+   public:
+    explicit Lock(LogBuffer *buffer);
+    ~Lock();
+
+   protected:
+#ifdef USE_ESP32
+    portMUX_TYPE *mux_;
+#else
+    // the ring is only shared with interrupts on single core platforms
+    InterruptLock lock_;
+#endif
+  };
+
+  Header *header_at_(size_t offset) { return reinterpret_cast<Header *>(this->buffer_ + offset); }
+  /// Size of the record for a message of length characters, padded so the next header is aligned.
+  static size_t record_size_(uint16_t length) {
+    return (sizeof(Header) + length + 1 + alignof(Header) - 1) & ~(alignof(Header) - 1);
+  }
+  /// Offset of the record at or after offset, following wrap markers.
+  size_t resolve_(size_t offset);
+  /// Find a contiguous free region of size bytes, returns false if there is none.
+  bool reserve_(size_t size, size_t *offset);
+
+  uint8_t *buffer_;
+  size_t capacity_;
+  size_t head_{0};
+  size_t tail_{0};
+  size_t records_{0};
+  volatile uint32_t dropped_{0};
+#ifdef USE_ESP32
+  portMUX_TYPE mux_ = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+}  // namespace logger
+}  // namespace esphome
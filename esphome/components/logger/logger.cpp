@@ -8,9 +8,15 @@
 #if defined(USE_ESP32_FRAMEWORK_ARDUINO) || defined(USE_ESP_IDF)
 #include <esp_log.h>
 #endif  // USE_ESP32_FRAMEWORK_ARDUINO || USE_ESP_IDF
+#ifdef USE_RP2040
+#include <pico/platform.h>
+#endif  // USE_RP2040
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace esphome {
 namespace logger {
 
@@ -49,21 +55,39 @@ void Logger::write_header_(int level, const char *tag, int line) {
 }
 
 void HOT Logger::log_vprintf_(int level, const char *tag, int line, const char *format, va_list args) {  // NOLINT
-  if (level > this->level_for(tag) || recursion_guard_)
+  if (level > this->min_tag_level_ && level > this->level_for(tag))
+    return;
+#ifdef USE_ESP32
+  if (this->async_buffer_ != nullptr && xPortInIsrContext()) {
+    this->log_from_isr_(level, tag, line, format);
+    return;
+  }
+  if (this->async_buffer_ != nullptr && xTaskGetCurrentTaskHandle() != this->main_task_) {
+    this->log_from_task_(level, tag, line, format, args);
+    return;
+  }
+#endif
+  if (recursion_guard_)
     return;
 
   recursion_guard_ = true;
+  va_list args_copy;
+  va_copy(args_copy, args);
   this->reset_buffer_();
   this->write_header_(level, tag, line);
   this->vprintf_to_buffer_(format, args);
   this->write_footer_();
+  LogFormat current{line, format, &args_copy};
+  this->current_format_ = &current;
   this->log_message_(level, tag);
+  this->current_format_ = nullptr;
+  va_end(args_copy);
   recursion_guard_ = false;
 }
 #ifdef USE_STORE_LOG_STR_IN_FLASH
 void Logger::log_vprintf_(int level, const char *tag, int line, const __FlashStringHelper *format,
                           va_list args) {  // NOLINT
-  if (level > this->level_for(tag) || recursion_guard_)
+  if ((level > this->min_tag_level_ && level > this->level_for(tag)) || recursion_guard_)
     return;
 
   recursion_guard_ = true;
@@ -91,17 +115,57 @@ void Logger::log_vprintf_(int level, const char *tag, int line, const __FlashStr
 }
 #endif
 
+/// How many consecutive cache slots a tag may be placed in, tags that don't fit are looked up uncached.
+static const size_t TAG_LEVEL_CACHE_PROBES = 8;
+
 int HOT Logger::level_for(const char *tag) {
-  // Uses std::vector<> for low memory footprint, though the vector
-  // could be sorted to minimize lookup times. This feature isn't used that
-  // much anyway so it doesn't matter too much.
-  for (auto &it : this->log_levels_) {
+  if (this->tag_levels_ == nullptr)
+    return ESPHOME_LOG_LEVEL;
+
+  // tags are string literals, so cache the level by address and only compare strings the first time a tag is seen
+  const uintptr_t address = reinterpret_cast<uintptr_t>(tag);
+  size_t index = (address ^ (address >> 6)) & (TAG_LEVEL_CACHE_SIZE - 1);
+  for (size_t i = 0; i < TAG_LEVEL_CACHE_PROBES; i++, index = (index + 1) & (TAG_LEVEL_CACHE_SIZE - 1)) {
+    TagLevel &entry = this->tag_levels_[index];
+    const char *cached = __atomic_load_n(&entry.tag, __ATOMIC_ACQUIRE);
+    if (cached == tag)
+      return entry.level;
+    if (cached == nullptr) {
+      const int level = this->find_level_(tag);
+      if (this->can_cache_level_()) {
+        // publish the tag last, so readers on other tasks never see it with a stale level
+        entry.level = level;
+        __atomic_store_n(&entry.tag, tag, __ATOMIC_RELEASE);
+      }
+      return level;
+    }
+  }
+  return this->find_level_(tag);
+}
+int Logger::find_level_(const char *tag) const {
+  for (const auto &it : this->log_levels_) {
     if (it.tag == tag) {
       return it.level;
     }
   }
   return ESPHOME_LOG_LEVEL;
 }
+bool Logger::can_cache_level_() const {
+#ifdef USE_ESP32
+  // only the main loop inserts, so two tasks never race for the same slot
+  return !xPortInIsrContext() && xTaskGetCurrentTaskHandle() == this->main_task_;
+#elif defined(USE_ESP8266)
+  // an interrupt could insert into the slot the loop is halfway through, so only cache at interrupt level 0
+  uint32_t ps;
+  __asm__ __volatile__("rsr %0,ps" : "=a"(ps));
+  return (ps & 0x0F) == 0;
+#elif defined(USE_RP2040)
+  // core1 and interrupt handlers could race the main loop for the same slot
+  return get_core_num() == 0 && __get_current_exception() == 0;
+#else
+  return true;
+#endif
+}
 void HOT Logger::log_message_(int level, const char *tag, int offset) {
   // remove trailing newline
   if (this->tx_buffer_[this->tx_buffer_at_ - 1] == '\n') {
@@ -111,6 +175,18 @@ void HOT Logger::log_message_(int level, const char *tag, int offset) {
   this->set_null_terminator_();
 
   const char *msg = this->tx_buffer_ + offset;
+  if (this->async_active_) {
+    const uint16_t length = this->tx_buffer_at_ - offset;
+    char *queued = this->async_buffer_->acquire(level, tag, length);
+    if (queued != nullptr) {
+      memcpy(queued, msg, length + 1);
+      this->async_buffer_->commit(queued);
+    }
+    return;
+  }
+  this->write_message_(level, tag, msg);
+}
+void HOT Logger::write_message_(int level, const char *tag, const char *msg) {
   if (this->baud_rate_ > 0) {
 #ifdef USE_ARDUINO
     this->hw_serial_->println(msg);
@@ -148,6 +224,123 @@ void HOT Logger::log_message_(int level, const char *tag, int offset) {
   this->log_callback_.call(level, tag, msg);
 }
 
+#ifdef USE_ESP32
+void Logger::log_from_task_(int level, const char *tag, int line, const char *format, va_list args) {
+  // tx_buffer_ belongs to the main loop, so measure the message first and format it straight into the buffer
+  const int clamped = std::max(0, std::min(level, 7));
+  const char *color = LOG_LEVEL_COLORS[clamped];
+  const char *letter = LOG_LEVEL_LETTERS[clamped];
+  va_list args_copy;
+  va_copy(args_copy, args);
+  const int header_length = snprintf(nullptr, 0, "%s[%s][%s:%03u]: ", color, letter, tag, line);
+  const int body_length = vsnprintf(nullptr, 0, format, args_copy);
+  va_end(args_copy);
+  if (header_length < 0 || body_length < 0)
+    return;
+  const int footer_length = strlen(ESPHOME_LOG_RESET_COLOR);
+  const int length = std::min(header_length + body_length + footer_length, this->tx_buffer_size_);
+
+  char *msg = this->async_buffer_->acquire(level, tag, length);
+  if (msg == nullptr)
+    return;
+  snprintf(msg, length + 1, "%s[%s][%s:%03u]: ", color, letter, tag, line);
+  int at = std::min(header_length, length);
+  vsnprintf(msg + at, length + 1 - at, format, args);
+  at = std::min(at + body_length, length);
+  memcpy(msg + at, ESPHOME_LOG_RESET_COLOR, length - at);
+  msg[length] = '\0';
+  this->async_buffer_->commit(msg);
+}
+
+void Logger::log_from_isr_(int level, const char *tag, int line, const char *format) {
+  // vsnprintf may take locks or allocate, which isn't allowed in an interrupt, so the message is put together with
+  // plain copies and the format string is queued without its arguments
+  const int clamped = std::max(0, std::min(level, 7));
+  char line_str[12];
+  char *line_end = line_str + sizeof(line_str) - 1;
+  char *line_start = line_end;
+  *line_end = '\0';
+  uint32_t value = line;
+  do {
+    *--line_start = '0' + value % 10;
+    value /= 10;
+  } while (value != 0 || line_end - line_start < 3);
+
+  const char *const parts[] = {LOG_LEVEL_COLORS[clamped], "[", LOG_LEVEL_LETTERS[clamped], "][", tag, ":",
+                               line_start, "]: ", format, ESPHOME_LOG_RESET_COLOR};
+  size_t length = 0;
+  for (const char *part : parts)
+    length += strlen(part);
+  length = std::min(length, static_cast<size_t>(this->tx_buffer_size_));
+
+  char *msg = this->async_buffer_->acquire(level, tag, length);
+  if (msg == nullptr)
+    return;
+  size_t at = 0;
+  for (const char *part : parts) {
+    const size_t part_length = std::min(strlen(part), length - at);
+    memcpy(msg + at, part, part_length);
+    at += part_length;
+  }
+  msg[length] = '\0';
+  this->async_buffer_->commit(msg);
+}
+#endif
+
+/// How long one loop may spend writing out queued messages.
+static const uint32_t ASYNC_DRAIN_BUDGET_MS = 5;
+
+void Logger::set_async_buffer_size(size_t size) {
+  this->async_buffer_ = make_unique<LogBuffer>(size);
+  if (this->async_buffer_->get_capacity() == 0)
+    this->async_buffer_ = nullptr;
+}
+
+void Logger::loop() {
+  if (this->async_buffer_ == nullptr)
+    return;
+  this->async_active_ = true;
+  this->drain_async_buffer_(false);
+}
+
+void Logger::on_shutdown() {
+  if (this->async_buffer_ == nullptr)
+    return;
+  // write out everything that is left and don't queue the messages logged while shutting down
+  this->drain_async_buffer_(true);
+  this->async_active_ = false;
+}
+
+void Logger::drain_async_buffer_(bool force) {
+  uint8_t level;
+  const char *tag;
+  const char *msg;
+  uint16_t length;
+  bool first = true;
+  const uint32_t started = millis();
+  while (this->async_buffer_->front(&level, &tag, &msg, &length)) {
+    // a task that logs a lot mustn't keep the main loop busy, the rest is written in the next loops
+    if (!force && !first && millis() - started >= ASYNC_DRAIN_BUDGET_MS)
+      break;
+#ifdef USE_ARDUINO
+    // wait for the UART instead of blocking on it, but write at least one message per loop so long ones get through
+    if (!force && !first && this->baud_rate_ > 0 && this->hw_serial_->availableForWrite() < length + 2)
+      break;
+#endif
+    this->recursion_guard_ = true;
+    this->write_message_(level, tag, msg);
+    this->recursion_guard_ = false;
+    this->async_buffer_->pop();
+    first = false;
+  }
+
+  const uint32_t dropped = this->async_buffer_->get_dropped();
+  if (dropped != this->async_dropped_reported_) {
+    ESP_LOGW(TAG, "Log buffer full, dropped %u messages", dropped - this->async_dropped_reported_);
+    this->async_dropped_reported_ = dropped;
+  }
+}
+
 Logger::Logger(uint32_t baud_rate, size_t tx_buffer_size) : baud_rate_(baud_rate), tx_buffer_size_(tx_buffer_size) {
   // add 1 to buffer size for null terminator
   this->tx_buffer_ = new char[this->tx_buffer_size_ + 1];  // NOLINT
@@ -248,6 +441,9 @@ void Logger::pre_setup() {
 #endif  // USE_ESP8266
 
   global_logger = this;
+#ifdef USE_ESP32
+  this->main_task_ = xTaskGetCurrentTaskHandle();
+#endif
 #if defined(USE_ESP_IDF) || defined(USE_ESP32_FRAMEWORK_ARDUINO)
   esp_log_set_vprintf(esp_idf_log_vprintf_);
   if (ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE) {
@@ -260,6 +456,13 @@ void Logger::pre_setup() {
 void Logger::set_baud_rate(uint32_t baud_rate) { this->baud_rate_ = baud_rate; }
 void Logger::set_log_level(const std::string &tag, int log_level) {
   this->log_levels_.push_back(LogLevelOverride{tag, log_level});
+  this->min_tag_level_ = std::min(this->min_tag_level_, log_level);
+  // overrides are set up before any other task logs, so the cache can be reset without synchronization
+  if (this->tag_levels_ == nullptr) {
+    this->tag_levels_.reset(new TagLevel[TAG_LEVEL_CACHE_SIZE]());  // NOLINT(cppcoreguidelines-owning-memory)
+  } else {
+    std::fill_n(this->tag_levels_.get(), TAG_LEVEL_CACHE_SIZE, TagLevel{});
+  }
 }
 UARTSelection Logger::get_uart() const { return this->uart_; }
 void Logger::add_on_log_callback(std::function<void(int, const char *, const char *)> &&callback) {
@@ -294,6 +497,8 @@ void Logger::dump_config() {
   ESP_LOGCONFIG(TAG, "  Level: %s", LOG_LEVELS[ESPHOME_LOG_LEVEL]);
   ESP_LOGCONFIG(TAG, "  Log Baud Rate: %u", this->baud_rate_);
   ESP_LOGCONFIG(TAG, "  Hardware UART: %s", UART_SELECTIONS[this->uart_]);
+  if (this->async_buffer_ != nullptr)
+    ESP_LOGCONFIG(TAG, "  Async Buffer Size: %u", this->async_buffer_->get_capacity());
   for (auto &it : this->log_levels_) {
     ESP_LOGCONFIG(TAG, "  Level for '%s': %s", it.tag.c_str(), LOG_LEVELS[it.level]);
   }
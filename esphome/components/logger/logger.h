@@ -1,11 +1,15 @@
 #pragma once
 
 #include <cstdarg>
+#include <memory>
 #include <vector>
 #include "esphome/core/automation.h"
 #include "esphome/core/component.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include "log_buffer.h"
 
 #ifdef USE_ARDUINO
 #if defined(USE_ESP8266) || defined(USE_ESP32)
@@ -21,6 +25,11 @@
 #include <driver/uart.h>
 #endif  // USE_ESP_IDF
 
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif  // USE_ESP32
+
 namespace esphome {
 
 namespace logger {
@@ -53,6 +62,14 @@ enum UARTSelection {
 #endif  // USE_RP2040
 };
 
+/// The unformatted form of a log message.
+struct LogFormat {
+  int line;
+  const char *format;
+  /// Shared by all log callbacks, so only read them through a va_copy().
+  va_list *args;
+};
+
 class Logger : public Component {
  public:
   explicit Logger(uint32_t baud_rate, size_t tx_buffer_size);
@@ -68,6 +85,12 @@ class Logger : public Component {
 #endif
 
   void set_uart_selection(UARTSelection uart_selection) { uart_ = uart_selection; }
+  /** Queue messages in a buffer of this many bytes and write them out from loop(), instead of blocking the caller.
+   *
+   * This also makes logging from other tasks safe. Messages are written synchronously until the first loop(), so
+   * nothing is lost if setup crashes.
+   */
+  void set_async_buffer_size(size_t size);
   /// Get the UART used by the logger.
   UARTSelection get_uart() const;
 
@@ -78,12 +101,20 @@ class Logger : public Component {
   // (In most use cases you won't need these)
   /// Set up this component.
   void pre_setup();
+  void loop() override;
   void dump_config() override;
+  void on_shutdown() override;
 
   int level_for(const char *tag);
 
   /// Register a callback that will be called for every log message sent
   void add_on_log_callback(std::function<void(int, const char *, const char *)> &&callback);
+  /** The format string and arguments of the message that is currently passed to the log callbacks.
+   *
+   * Returns nullptr if they are not known, which is the case for messages that were queued in the async buffer, logged
+   * from other tasks or with a format string stored in flash.
+   */
+  const LogFormat *get_current_format() const { return this->current_format_; }
 
   float get_setup_priority() const override;
 
@@ -93,9 +124,24 @@ class Logger : public Component {
 #endif
 
  protected:
+  /// Find the level of a tag in the overrides, comparing it to each of them.
+  int find_level_(const char *tag) const;
+  /// Whether the calling context may insert into the tag level cache.
+  bool can_cache_level_() const;
   void write_header_(int level, const char *tag, int line);
   void write_footer_();
   void log_message_(int level, const char *tag, int offset = 0);
+  /// Write a formatted message to the UART and the log callbacks.
+  void write_message_(int level, const char *tag, const char *msg);
+#ifdef USE_ESP32
+  /// Format a message from a task other than the main loop directly into the async buffer.
+  void log_from_task_(int level, const char *tag, int line, const char *format, va_list args);
+  /// Queue a message logged from an interrupt, with the format string as is since it can't be formatted there.
+  void log_from_isr_(int level, const char *tag, int line, const char *format);
+#endif
+  /// Write out the queued messages, stopping early if the UART can't take them without blocking or the loop budget is
+  /// used up, unless force is set.
+  void drain_async_buffer_(bool force);
 
   inline bool is_buffer_full_() const { return this->tx_buffer_at_ >= this->tx_buffer_size_; }
   inline int buffer_remaining_capacity_() const { return this->tx_buffer_size_ - this->tx_buffer_at_; }
@@ -151,9 +197,26 @@ class Logger : public Component {
     int level;
   };
   std::vector<LogLevelOverride> log_levels_;
+  static const size_t TAG_LEVEL_CACHE_SIZE = 64;
+  struct TagLevel {
+    const char *tag;
+    int level;
+  };
+  /// Open addressing cache of level_for() by tag address, only allocated if there are overrides.
+  std::unique_ptr<TagLevel[]> tag_levels_;
+  /// Lowest level of all tags, messages at or below it are logged without looking up their tag.
+  int min_tag_level_{ESPHOME_LOG_LEVEL};
   CallbackManager<void(int, const char *, const char *)> log_callback_{};
   /// Prevents recursive log calls, if true a log message is already being processed.
   bool recursion_guard_ = false;
+  const LogFormat *current_format_{nullptr};
+  std::unique_ptr<LogBuffer> async_buffer_;
+  /// Set once loop() ran, messages are written synchronously before that.
+  bool async_active_{false};
+  uint32_t async_dropped_reported_{0};
+#ifdef USE_ESP32
+  TaskHandle_t main_task_{nullptr};
+#endif
 };
 
 extern Logger *global_logger;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
@@ -24,13 +24,15 @@ void Modbus::loop() {
     waiting_for_response = 0;
   }
 
-  while (this->available()) {
-    uint8_t byte;
-    this->read_byte(&byte);
-    if (this->parse_modbus_byte_(byte)) {
-      this->last_modbus_byte_ = now;
-    } else {
-      this->rx_buffer_.clear();
+  uint8_t buf[64];
+  size_t len;
+  while ((len = this->read_available(buf, sizeof(buf))) > 0) {
+    for (size_t i = 0; i < len; i++) {
+      if (this->parse_modbus_byte_(buf[i])) {
+        this->last_modbus_byte_ = now;
+      } else {
+        this->rx_buffer_.clear();
+      }
     }
   }
 }
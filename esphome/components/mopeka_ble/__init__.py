@@ -20,4 +20,6 @@ CONFIG_SCHEMA = cv.Schema(
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
-    await esp32_ble_tracker.register_ble_device(var, config)
+    await esp32_ble_tracker.register_ble_device(
+        var, config, manufacturer_id=0x0059
+    )
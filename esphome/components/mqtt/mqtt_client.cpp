@@ -6,6 +6,7 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "esphome/components/network/util.h"
+#include <algorithm>
 #include <utility>
 #ifdef USE_LOGGER
 #include "esphome/components/logger/logger.h"
@@ -19,6 +20,11 @@ namespace mqtt {
 
 static const char *const TAG = "mqtt";
 
+/// Maximum time spent publishing discovery messages per loop iteration.
+static const uint32_t DISCOVERY_LOOP_BUDGET_MS = 20;
+/// Maximum time spent sending queued messages per loop iteration.
+static const uint32_t PUBLISH_QUEUE_LOOP_BUDGET_MS = 20;
+
 MQTTClientComponent::MQTTClientComponent() {
   global_mqtt_client = this;
   this->credentials_.client_id = App.get_name() + "-" + get_mac_address();
@@ -37,7 +43,12 @@ void MQTTClientComponent::setup() {
 
         // MQTT fully received
         if (len + index == total) {
+#ifdef USE_ESP8266
+          // dispatch is deferred on ESP8266, hand the buffer over instead of copying it
+          this->on_message(topic, std::move(this->payload_buffer_));
+#else
           this->on_message(topic, this->payload_buffer_);
+#endif
           this->payload_buffer_.clear();
         }
       });
@@ -58,6 +69,18 @@ void MQTTClientComponent::setup() {
   }
 #endif
 
+  if (this->is_discovery_enabled()) {
+    // Home Assistant announces a restart on <prefix>/status; it has lost all discovery info then.
+    this->subscribe(this->discovery_info_.prefix + "/status",
+                    [this](const std::string &topic, const std::string &payload) {
+                      if (payload != "online")
+                        return;
+                      for (MQTTComponent *component : this->children_)
+                        component->invalidate_discovery_();
+                      this->discovery_index_ = 0;
+                    });
+  }
+
   this->last_connected_ = millis();
   this->start_dnslookup_();
 }
@@ -78,6 +101,9 @@ void MQTTClientComponent::dump_config() {
   if (!this->availability_.topic.empty()) {
     ESP_LOGCONFIG(TAG, "  Availability: '%s'", this->availability_.topic.c_str());
   }
+  if (this->publish_queue_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Publish Queue: %u bytes", this->publish_queue_->get_capacity());
+  }
 }
 bool MQTTClientComponent::can_proceed() { return this->is_connected(); }
 
@@ -219,8 +245,29 @@ void MQTTClientComponent::check_connected() {
 
   this->resubscribe_subscriptions_();
 
-  for (MQTTComponent *component : this->children_)
+  // discovery payloads that were published before are skipped, so this resumes after a connection loss
+  this->discovery_index_ = 0;
+}
+
+void MQTTClientComponent::process_discovery_() {
+  if (this->publish_queue_ != nullptr && !this->publish_queue_->empty()) {
+    // send what is queued first, the discovery messages would just end up behind it
+    return;
+  }
+
+  const uint32_t start = millis();
+  while (this->discovery_index_ < this->children_.size()) {
+    MQTTComponent *component = this->children_[this->discovery_index_];
+    if (component->is_discovery_enabled() && !component->send_discovery_()) {
+      // the backend can't take more right now, continue with this component in the next loop iteration
+      break;
+    }
     component->schedule_resend_state();
+    this->discovery_index_++;
+
+    if (millis() - start > DISCOVERY_LOOP_BUDGET_MS)
+      break;
+  }
 }
 
 void MQTTClientComponent::loop() {
@@ -286,11 +333,13 @@ void MQTTClientComponent::loop() {
         this->start_dnslookup_();
       } else {
         if (!this->birth_message_.topic.empty() && !this->sent_birth_message_) {
-          this->sent_birth_message_ = this->publish(this->birth_message_);
+          this->sent_birth_message_ = this->publish_now_(this->birth_message_);
         }
 
         this->last_connected_ = now;
+        this->drain_publish_queue_();
         this->resubscribe_subscriptions_();
+        this->process_discovery_();
       }
       break;
   }
@@ -337,31 +386,60 @@ void MQTTClientComponent::resubscribe_subscriptions_() {
   }
 }
 
+void MQTTClientComponent::add_subscription_(MQTTSubscription &&subscription) {
+  this->resubscribe_subscription_(&subscription);
+  if (this->dispatching_) {
+    // growing subscriptions_ could move the callback that is running
+    this->pending_subscriptions_.push_back(std::move(subscription));
+    return;
+  }
+  this->subscription_trie_.insert(subscription.topic, this->subscriptions_.size());
+  this->subscriptions_.push_back(std::move(subscription));
+}
+
+void MQTTClientComponent::compact_subscriptions_() {
+  if (this->subscriptions_removed_) {
+    this->subscriptions_removed_ = false;
+    this->subscriptions_.erase(std::remove_if(this->subscriptions_.begin(), this->subscriptions_.end(),
+                                              [](const MQTTSubscription &sub) { return sub.removed; }),
+                               this->subscriptions_.end());
+    // indices have shifted, rebuild the trie
+    this->subscription_trie_.clear();
+    for (size_t i = 0; i < this->subscriptions_.size(); i++)
+      this->subscription_trie_.insert(this->subscriptions_[i].topic, i);
+  }
+  for (auto &subscription : this->pending_subscriptions_) {
+    if (subscription.removed)
+      continue;
+    this->subscription_trie_.insert(subscription.topic, this->subscriptions_.size());
+    this->subscriptions_.push_back(std::move(subscription));
+  }
+  this->pending_subscriptions_.clear();
+}
+
 void MQTTClientComponent::subscribe(const std::string &topic, mqtt_callback_t callback, uint8_t qos) {
-  MQTTSubscription subscription{
+  this->add_subscription_(MQTTSubscription{
       .topic = topic,
       .qos = qos,
       .callback = std::move(callback),
       .subscribed = false,
       .resubscribe_timeout = 0,
-  };
-  this->resubscribe_subscription_(&subscription);
-  this->subscriptions_.push_back(subscription);
+      .removed = false,
+  });
 }
 
 void MQTTClientComponent::subscribe_json(const std::string &topic, const mqtt_json_callback_t &callback, uint8_t qos) {
   auto f = [callback](const std::string &topic, const std::string &payload) {
     json::parse_json(payload, [topic, callback](JsonObject root) { callback(topic, root); });
   };
-  MQTTSubscription subscription{
+  this->add_subscription_(MQTTSubscription{
       .topic = topic,
       .qos = qos,
       .callback = f,
       .subscribed = false,
       .resubscribe_timeout = 0,
-  };
-  this->resubscribe_subscription_(&subscription);
-  this->subscriptions_.push_back(subscription);
+      .removed = false,
+  });
 }
 
 void MQTTClientComponent::unsubscribe(const std::string &topic) {
@@ -375,14 +453,21 @@ void MQTTClientComponent::unsubscribe(const std::string &topic) {
     this->status_momentary_warning("unsubscribe", 1000);
   }
 
-  auto it = subscriptions_.begin();
-  while (it != subscriptions_.end()) {
-    if (it->topic == topic) {
-      it = subscriptions_.erase(it);
-    } else {
-      ++it;
+  for (auto &subscription : this->subscriptions_) {
+    if (subscription.topic == topic) {
+      subscription.removed = true;
+      this->subscriptions_removed_ = true;
     }
   }
+  for (auto &subscription : this->pending_subscriptions_) {
+    if (subscription.topic == topic) {
+      subscription.removed = true;
+      this->subscriptions_removed_ = true;
+    }
+  }
+  // while dispatching, the entries are removed once the callbacks are done
+  if (!this->dispatching_)
+    this->compact_subscriptions_();
 }
 
 // Publish
@@ -392,10 +477,28 @@ bool MQTTClientComponent::publish(const std::string &topic, const std::string &p
 
 bool MQTTClientComponent::publish(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
                                   bool retain) {
-  return publish({.topic = topic, .payload = payload, .qos = qos, .retain = retain});
+  return publish({.topic = topic, .payload = std::string(payload, payload_length), .qos = qos, .retain = retain});
 }
 
 bool MQTTClientComponent::publish(const MQTTMessage &message) {
+  if (this->publish_queue_ == nullptr || this->log_message_.topic == message.topic)
+    return this->publish_now_(message);
+
+  // messages queued before must go out first
+  if (this->publish_queue_->empty() && this->publish_now_(message))
+    return true;
+  size_t evicted = 0;
+  const bool queued = this->publish_queue_->push(message, &evicted);
+  if (evicted > 0)
+    this->publish_queue_evicted_ = true;
+  if (!queued) {
+    ESP_LOGV(TAG, "Publish queue overflow, dropped message for topic='%s'", message.topic.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool MQTTClientComponent::publish_now_(const MQTTMessage &message) {
   if (!this->is_connected()) {
     // critical components will re-transmit their messages
     return false;
@@ -421,81 +524,73 @@ bool MQTTClientComponent::publish(const MQTTMessage &message) {
   }
   return ret != 0;
 }
-bool MQTTClientComponent::publish_json(const std::string &topic, const json::json_build_t &f, uint8_t qos,
-                                       bool retain) {
-  std::string message = json::build_json(f);
-  return this->publish(topic, message, qos, retain);
-}
-
-/** Check if the message topic matches the given subscription topic
- *
- * INFO: MQTT spec mandates that topics must not be empty and must be valid NULL-terminated UTF-8 strings.
- *
- * @param message The message topic that was received from the MQTT server. Note: this must not contain
- *                wildcard characters as mandated by the MQTT spec.
- * @param subscription The subscription topic we are matching against.
- * @param is_normal Is this a "normal" topic - Does the message topic not begin with a "$".
- * @param past_separator Are we past the first '/' topic separator.
- * @return true if the subscription topic matches the message topic, false otherwise.
- */
-static bool topic_match(const char *message, const char *subscription, bool is_normal, bool past_separator) {
-  // Reached end of both strings at the same time, this means we have a successful match
-  if (*message == '\0' && *subscription == '\0')
-    return true;
-
-  // Either the message or the subscribe are at the end. This means they don't match.
-  if (*message == '\0' || *subscription == '\0')
-    return false;
-
-  bool do_wildcards = is_normal || past_separator;
+void MQTTClientComponent::drain_publish_queue_() {
+  if (this->publish_queue_ == nullptr || this->publish_queue_->empty())
+    return;
 
-  if (*subscription == '+' && do_wildcards) {
-    // single level wildcard
-    // consume + from subscription
-    subscription++;
-    // consume everything from message until '/' found or end of string
-    while (*message != '\0' && *message != '/') {
-      message++;
+  const uint32_t start = millis();
+  do {
+    MQTTQueuedMessage message = this->publish_queue_->front();
+    if (!this->mqtt_backend_.publish(message.topic, message.payload, message.payload_length, message.qos,
+                                     message.retain)) {
+      // the backend buffer is full, retry in the next loop iteration
+      break;
     }
-    // after this, both pointers will point to a '/' or to the end of the string
+    this->publish_queue_->pop();
+    delay(0);
+  } while (!this->publish_queue_->empty() && millis() - start < PUBLISH_QUEUE_LOOP_BUDGET_MS);
 
-    return topic_match(message, subscription, is_normal, true);
+  if (this->publish_queue_->empty() && this->publish_queue_->get_dropped() != this->publish_queue_reported_drops_) {
+    ESP_LOGW(TAG, "Publish queue overflowed, %u messages were dropped",
+             this->publish_queue_->get_dropped() - this->publish_queue_reported_drops_);
+    this->publish_queue_reported_drops_ = this->publish_queue_->get_dropped();
   }
-
-  if (*subscription == '#' && do_wildcards) {
-    // multilevel wildcard - MQTT mandates that this must be at end of subscribe topic
-    return true;
+  if (this->publish_queue_->empty() && this->publish_queue_evicted_) {
+    // the evicted messages are gone, publish the current states again instead
+    this->publish_queue_evicted_ = false;
+    for (MQTTComponent *component : this->children_)
+      component->schedule_resend_state();
   }
+}
 
-  // this handles '/' and normal characters at the same time.
-  if (*message != *subscription)
-    return false;
-
-  past_separator = past_separator || *subscription == '/';
-
-  // consume characters
-  subscription++;
-  message++;
-
-  return topic_match(message, subscription, is_normal, past_separator);
+bool MQTTClientComponent::publish_json(const std::string &topic, const json::json_build_t &f, uint8_t qos,
+                                       bool retain) {
+  std::string message = json::build_json(f);
+  return this->publish(topic, message, qos, retain);
 }
 
-static bool topic_match(const char *message, const char *subscription) {
-  return topic_match(message, subscription, *message != '\0' && *message != '$', false);
+void MQTTClientComponent::dispatch_message_(const std::string &topic, const std::string &payload) {
+  this->matched_subscriptions_.clear();
+  this->subscription_trie_.match(topic.c_str(), this->matched_subscriptions_);
+  // keep the callback order stable, regardless of the trie layout
+  std::sort(this->matched_subscriptions_.begin(), this->matched_subscriptions_.end());
+  // callbacks may subscribe or unsubscribe, those changes are deferred until all of them were called
+  this->dispatching_ = true;
+  for (size_t index : this->matched_subscriptions_) {
+    const MQTTSubscription &subscription = this->subscriptions_[index];
+    if (!subscription.removed)
+      subscription.callback(topic, payload);
+  }
+  this->dispatching_ = false;
+  if (this->subscriptions_removed_ || !this->pending_subscriptions_.empty())
+    this->compact_subscriptions_();
 }
 
 void MQTTClientComponent::on_message(const std::string &topic, const std::string &payload) {
 #ifdef USE_ESP8266
   // on ESP8266, this is called in LWiP thread; some components do not like running
   // in an ISR.
-  this->defer([this, topic, payload]() {
+  this->defer([this, topic, payload]() { this->dispatch_message_(topic, payload); });
+#else
+  this->dispatch_message_(topic, payload);
 #endif
-    for (auto &subscription : this->subscriptions_) {
-      if (topic_match(topic.c_str(), subscription.topic.c_str()))
-        subscription.callback(topic, payload);
-    }
+}
+
+void MQTTClientComponent::on_message(std::string &&topic, std::string &&payload) {
 #ifdef USE_ESP8266
-  });
+  this->defer(std::bind(&MQTTClientComponent::dispatch_message_, this, std::move(topic), std::move(payload)));
+#else
+  this->dispatch_message_(topic, payload);
 #endif
 }
 
@@ -503,6 +598,15 @@ void MQTTClientComponent::on_message(const std::string &topic, const std::string
 void MQTTClientComponent::disable_log_message() { this->log_message_.topic = ""; }
 bool MQTTClientComponent::is_log_message_enabled() const { return !this->log_message_.topic.empty(); }
 void MQTTClientComponent::set_reboot_timeout(uint32_t reboot_timeout) { this->reboot_timeout_ = reboot_timeout; }
+void MQTTClientComponent::set_publish_queue_size(size_t size) {
+  this->publish_queue_ = make_unique<MQTTPublishQueue>(size);
+}
+size_t MQTTClientComponent::get_publish_queue_depth() const {
+  return this->publish_queue_ == nullptr ? 0 : this->publish_queue_->get_depth();
+}
+uint32_t MQTTClientComponent::get_publish_queue_dropped() const {
+  return this->publish_queue_ == nullptr ? 0 : this->publish_queue_->get_dropped();
+}
 void MQTTClientComponent::register_mqtt_component(MQTTComponent *component) { this->children_.push_back(component); }
 void MQTTClientComponent::set_log_level(int level) { this->log_level_ = level; }
 void MQTTClientComponent::set_keep_alive(uint16_t keep_alive_s) { this->mqtt_backend_.set_keep_alive(keep_alive_s); }
@@ -566,7 +670,7 @@ void MQTTClientComponent::disable_discovery() {
 void MQTTClientComponent::on_shutdown() {
   if (!this->shutdown_message_.topic.empty()) {
     yield();
-    this->publish(this->shutdown_message_);
+    this->publish_now_(this->shutdown_message_);
     yield();
   }
   this->mqtt_backend_.disconnect();
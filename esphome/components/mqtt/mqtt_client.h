@@ -14,8 +14,11 @@
 #elif defined(USE_ARDUINO)
 #include "mqtt_backend_arduino.h"
 #endif
+#include "mqtt_publish_queue.h"
+#include "mqtt_topic_trie.h"
 #include "lwip/ip_addr.h"
 
+#include <memory>
 #include <vector>
 
 namespace esphome {
@@ -40,6 +43,8 @@ struct MQTTSubscription {
   mqtt_callback_t callback;
   bool subscribed;
   uint32_t resubscribe_timeout;
+  /// Unsubscribed while a message was dispatched, removed once that is done.
+  bool removed;
 };
 
 /// internal struct for MQTT credentials.
@@ -169,7 +174,7 @@ class MQTTClientComponent : public Component {
 
   /** Subscribe to an MQTT topic and call callback when a message is received.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic. May contain the '+' and '#' wildcards.
    * @param callback The callback function.
    * @param qos The QoS of this subscription.
    */
@@ -179,7 +184,7 @@ class MQTTClientComponent : public Component {
    *
    * If an invalid JSON payload is received, the callback will not be called.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic. May contain the '+' and '#' wildcards.
    * @param callback The callback with a parsed JsonObject that will be called when a message with matching topic is
    * received.
    * @param qos The QoS of this subscription.
@@ -196,8 +201,12 @@ class MQTTClientComponent : public Component {
   void unsubscribe(const std::string &topic);
 
   /** Publish a MQTTMessage
+   *
+   * If a publish queue is configured, messages that can't be sent right now are queued and sent once the
+   * connection is back.
    *
    * @param message The message.
+   * @return Whether the message was sent or queued.
    */
   bool publish(const MQTTMessage &message);
 
@@ -229,6 +238,8 @@ class MQTTClientComponent : public Component {
   float get_setup_priority() const override;
 
   void on_message(const std::string &topic, const std::string &payload);
+  /// Dispatch a received message, taking ownership of the payload instead of copying it.
+  void on_message(std::string &&topic, std::string &&payload);
 
   bool can_proceed() override;
 
@@ -236,6 +247,13 @@ class MQTTClientComponent : public Component {
 
   void set_reboot_timeout(uint32_t reboot_timeout);
 
+  /// Buffer up to size bytes of messages while disconnected, see MQTTPublishQueue.
+  void set_publish_queue_size(size_t size);
+  /// Number of messages waiting in the publish queue.
+  size_t get_publish_queue_depth() const;
+  /// Number of messages dropped because the publish queue was full.
+  uint32_t get_publish_queue_dropped() const;
+
   void register_mqtt_component(MQTTComponent *component);
 
   bool is_connected();
@@ -264,9 +282,28 @@ class MQTTClientComponent : public Component {
   /// Re-calculate the availability property.
   void recalculate_availability_();
 
+  /** Publish the discovery info and initial state of the registered components, starting at discovery_index_.
+   *
+   * Stops as soon as the backend rejects a message or the per-loop time budget is used up, and continues
+   * from the same component in the next loop iteration.
+   */
+  void process_discovery_();
+
+  friend class MQTTComponent;
+
+  /// Send a message to the backend directly, bypassing the publish queue.
+  bool publish_now_(const MQTTMessage &message);
+  /// Send queued messages until the queue is empty, the backend is busy or the per-loop time budget is used up.
+  void drain_publish_queue_();
+
   bool subscribe_(const char *topic, uint8_t qos);
   void resubscribe_subscription_(MQTTSubscription *sub);
   void resubscribe_subscriptions_();
+  void add_subscription_(MQTTSubscription &&subscription);
+  /// Apply the subscription changes callbacks made while a message was dispatched.
+  void compact_subscriptions_();
+  /// Call the callbacks of all subscriptions matching the topic, in subscription order.
+  void dispatch_message_(const std::string &topic, const std::string &payload);
 
   MQTTCredentials credentials_;
   /// The last will message. Disabled optional denotes it being default and
@@ -294,6 +331,17 @@ class MQTTClientComponent : public Component {
   int log_level_{ESPHOME_LOG_LEVEL};
 
   std::vector<MQTTSubscription> subscriptions_;
+  /// Index of subscriptions_ by topic filter, used to dispatch inbound messages.
+  MQTTTopicTrie subscription_trie_;
+  std::vector<size_t> matched_subscriptions_;
+  /// Set while callbacks are called, subscriptions_ must not be reordered or reallocated then.
+  bool dispatching_{false};
+  bool subscriptions_removed_{false};
+  std::vector<MQTTSubscription> pending_subscriptions_;
+  std::unique_ptr<MQTTPublishQueue> publish_queue_;
+  uint32_t publish_queue_reported_drops_{0};
+  /// Queued messages were evicted to make room, so the components resend their state once the queue is drained.
+  bool publish_queue_evicted_{false};
 #if defined(USE_ESP_IDF)
   MQTTBackendIDF mqtt_backend_;
 #elif defined(USE_ARDUINO)
@@ -305,6 +353,8 @@ class MQTTClientComponent : public Component {
   bool dns_resolved_{false};
   bool dns_resolve_error_{false};
   std::vector<MQTTComponent *> children_;
+  /// Index into children_ of the next component to send discovery and state for.
+  size_t discovery_index_{0};
   uint32_t reboot_timeout_{300000};
   uint32_t connect_begin_;
   uint32_t last_connected_{0};
@@ -56,92 +56,109 @@ bool MQTTComponent::send_discovery_() {
 
   if (discovery_info.clean) {
     ESP_LOGV(TAG, "'%s': Cleaning discovery...", this->friendly_name().c_str());
-    return global_mqtt_client->publish(this->get_discovery_topic_(discovery_info), "", 0, 0, true);
+    this->discovery_hash_ = 0;
+    return global_mqtt_client->publish_now_(
+        {.topic = this->get_discovery_topic_(discovery_info), .payload = "", .qos = 0, .retain = true});
+  }
+
+  std::string payload = json::build_json([this](JsonObject root) {
+    SendDiscoveryConfig config;
+    config.state_topic = true;
+    config.command_topic = true;
+
+    this->send_discovery(root, config);
+
+    // Fields from EntityBase
+    root[MQTT_NAME] = this->friendly_name();
+    if (this->is_disabled_by_default())
+      root[MQTT_ENABLED_BY_DEFAULT] = false;
+    if (!this->get_icon().empty())
+      root[MQTT_ICON] = this->get_icon();
+
+    switch (this->get_entity()->get_entity_category()) {
+      case ENTITY_CATEGORY_NONE:
+        break;
+      case ENTITY_CATEGORY_CONFIG:
+        root[MQTT_ENTITY_CATEGORY] = "config";
+        break;
+      case ENTITY_CATEGORY_DIAGNOSTIC:
+        root[MQTT_ENTITY_CATEGORY] = "diagnostic";
+        break;
+    }
+
+    if (config.state_topic)
+      root[MQTT_STATE_TOPIC] = this->get_state_topic_();
+    if (config.command_topic)
+      root[MQTT_COMMAND_TOPIC] = this->get_command_topic_();
+    if (this->command_retain_)
+      root[MQTT_COMMAND_RETAIN] = true;
+
+    if (this->availability_ == nullptr) {
+      if (!global_mqtt_client->get_availability().topic.empty()) {
+        root[MQTT_AVAILABILITY_TOPIC] = global_mqtt_client->get_availability().topic;
+        if (global_mqtt_client->get_availability().payload_available != "online")
+          root[MQTT_PAYLOAD_AVAILABLE] = global_mqtt_client->get_availability().payload_available;
+        if (global_mqtt_client->get_availability().payload_not_available != "offline")
+          root[MQTT_PAYLOAD_NOT_AVAILABLE] = global_mqtt_client->get_availability().payload_not_available;
+      }
+    } else if (!this->availability_->topic.empty()) {
+      root[MQTT_AVAILABILITY_TOPIC] = this->availability_->topic;
+      if (this->availability_->payload_available != "online")
+        root[MQTT_PAYLOAD_AVAILABLE] = this->availability_->payload_available;
+      if (this->availability_->payload_not_available != "offline")
+        root[MQTT_PAYLOAD_NOT_AVAILABLE] = this->availability_->payload_not_available;
+    }
+
+    std::string unique_id = this->unique_id();
+    const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
+    if (!unique_id.empty()) {
+      root[MQTT_UNIQUE_ID] = unique_id;
+    } else {
+      if (discovery_info.unique_id_generator == MQTT_MAC_ADDRESS_UNIQUE_ID_GENERATOR) {
+        char friendly_name_hash[9];
+        sprintf(friendly_name_hash, "%08x", fnv1_hash(this->friendly_name()));
+        friendly_name_hash[8] = 0;  // ensure the hash-string ends with null
+        root[MQTT_UNIQUE_ID] = get_mac_address() + "-" + this->component_type() + "-" + friendly_name_hash;
+      } else {
+        // default to almost-unique ID. It's a hack but the only way to get that
+        // gorgeous device registry view.
+        root[MQTT_UNIQUE_ID] = "ESP" + this->component_type() + this->get_default_object_id_();
+      }
+    }
+
+    const std::string &node_name = App.get_name();
+    if (discovery_info.object_id_generator == MQTT_DEVICE_NAME_OBJECT_ID_GENERATOR)
+      root[MQTT_OBJECT_ID] = node_name + "_" + this->get_default_object_id_();
+
+    JsonObject device_info = root.createNestedObject(MQTT_DEVICE);
+    device_info[MQTT_DEVICE_IDENTIFIERS] = get_mac_address();
+    device_info[MQTT_DEVICE_NAME] = node_name;
+    device_info[MQTT_DEVICE_SW_VERSION] = "esphome v" ESPHOME_VERSION " " + App.get_compilation_time();
+    device_info[MQTT_DEVICE_MODEL] = ESPHOME_BOARD;
+    device_info[MQTT_DEVICE_MANUFACTURER] = "espressif";
+  });
+
+  const uint32_t hash = fnv1_hash(payload);
+  if (discovery_info.retain && hash == this->discovery_hash_) {
+    ESP_LOGV(TAG, "'%s': Discovery unchanged, not sending again", this->friendly_name().c_str());
+    return true;
   }
 
   ESP_LOGV(TAG, "'%s': Sending discovery...", this->friendly_name().c_str());
+  // bypass the publish queue, the hash must only be remembered once the broker really got the payload; if the
+  // backend can't take it right now, the client tries this component again in the next loop iteration
+  if (!global_mqtt_client->publish_now_({.topic = this->get_discovery_topic_(discovery_info),
+                                         .payload = std::move(payload),
+                                         .qos = 0,
+                                         .retain = discovery_info.retain}))
+    return false;
 
-  return global_mqtt_client->publish_json(
-      this->get_discovery_topic_(discovery_info),
-      [this](JsonObject root) {
-        SendDiscoveryConfig config;
-        config.state_topic = true;
-        config.command_topic = true;
-
-        this->send_discovery(root, config);
-
-        // Fields from EntityBase
-        root[MQTT_NAME] = this->friendly_name();
-        if (this->is_disabled_by_default())
-          root[MQTT_ENABLED_BY_DEFAULT] = false;
-        if (!this->get_icon().empty())
-          root[MQTT_ICON] = this->get_icon();
-
-        switch (this->get_entity()->get_entity_category()) {
-          case ENTITY_CATEGORY_NONE:
-            break;
-          case ENTITY_CATEGORY_CONFIG:
-            root[MQTT_ENTITY_CATEGORY] = "config";
-            break;
-          case ENTITY_CATEGORY_DIAGNOSTIC:
-            root[MQTT_ENTITY_CATEGORY] = "diagnostic";
-            break;
-        }
-
-        if (config.state_topic)
-          root[MQTT_STATE_TOPIC] = this->get_state_topic_();
-        if (config.command_topic)
-          root[MQTT_COMMAND_TOPIC] = this->get_command_topic_();
-        if (this->command_retain_)
-          root[MQTT_COMMAND_RETAIN] = true;
-
-        if (this->availability_ == nullptr) {
-          if (!global_mqtt_client->get_availability().topic.empty()) {
-            root[MQTT_AVAILABILITY_TOPIC] = global_mqtt_client->get_availability().topic;
-            if (global_mqtt_client->get_availability().payload_available != "online")
-              root[MQTT_PAYLOAD_AVAILABLE] = global_mqtt_client->get_availability().payload_available;
-            if (global_mqtt_client->get_availability().payload_not_available != "offline")
-              root[MQTT_PAYLOAD_NOT_AVAILABLE] = global_mqtt_client->get_availability().payload_not_available;
-          }
-        } else if (!this->availability_->topic.empty()) {
-          root[MQTT_AVAILABILITY_TOPIC] = this->availability_->topic;
-          if (this->availability_->payload_available != "online")
-            root[MQTT_PAYLOAD_AVAILABLE] = this->availability_->payload_available;
-          if (this->availability_->payload_not_available != "offline")
-            root[MQTT_PAYLOAD_NOT_AVAILABLE] = this->availability_->payload_not_available;
-        }
-
-        std::string unique_id = this->unique_id();
-        const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
-        if (!unique_id.empty()) {
-          root[MQTT_UNIQUE_ID] = unique_id;
-        } else {
-          if (discovery_info.unique_id_generator == MQTT_MAC_ADDRESS_UNIQUE_ID_GENERATOR) {
-            char friendly_name_hash[9];
-            sprintf(friendly_name_hash, "%08x", fnv1_hash(this->friendly_name()));
-            friendly_name_hash[8] = 0;  // ensure the hash-string ends with null
-            root[MQTT_UNIQUE_ID] = get_mac_address() + "-" + this->component_type() + "-" + friendly_name_hash;
-          } else {
-            // default to almost-unique ID. It's a hack but the only way to get that
-            // gorgeous device registry view.
-            root[MQTT_UNIQUE_ID] = "ESP" + this->component_type() + this->get_default_object_id_();
-          }
-        }
-
-        const std::string &node_name = App.get_name();
-        if (discovery_info.object_id_generator == MQTT_DEVICE_NAME_OBJECT_ID_GENERATOR)
-          root[MQTT_OBJECT_ID] = node_name + "_" + this->get_default_object_id_();
-
-        JsonObject device_info = root.createNestedObject(MQTT_DEVICE);
-        device_info[MQTT_DEVICE_IDENTIFIERS] = get_mac_address();
-        device_info[MQTT_DEVICE_NAME] = node_name;
-        device_info[MQTT_DEVICE_SW_VERSION] = "esphome v" ESPHOME_VERSION " " + App.get_compilation_time();
-        device_info[MQTT_DEVICE_MODEL] = ESPHOME_BOARD;
-        device_info[MQTT_DEVICE_MANUFACTURER] = "espressif";
-      },
-      0, discovery_info.retain);
+  this->discovery_hash_ = hash;
+  return true;
 }
 
+void MQTTComponent::invalidate_discovery_() { this->discovery_hash_ = 0; }
+
 bool MQTTComponent::get_retain() const { return this->retain_; }
 
 bool MQTTComponent::is_discovery_enabled() const {
@@ -186,19 +203,8 @@ void MQTTComponent::call_setup() {
 
   this->setup();
 
+  // discovery and the initial state are sent by the client once connected, spread over multiple loop iterations
   global_mqtt_client->register_mqtt_component(this);
-
-  if (!this->is_connected_())
-    return;
-
-  if (this->is_discovery_enabled()) {
-    if (!this->send_discovery_()) {
-      this->schedule_resend_state();
-    }
-  }
-  if (!this->send_initial_state()) {
-    this->schedule_resend_state();
-  }
 }
 
 void MQTTComponent::call_loop() {
@@ -212,11 +218,6 @@ void MQTTComponent::call_loop() {
   }
 
   this->resend_state_ = false;
-  if (this->is_discovery_enabled()) {
-    if (!this->send_discovery_()) {
-      this->schedule_resend_state();
-    }
-  }
   if (!this->send_initial_state()) {
     this->schedule_resend_state();
   }
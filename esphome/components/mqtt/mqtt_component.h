@@ -123,7 +123,7 @@ class MQTTComponent : public Component {
 
   /** Subscribe to a MQTT topic.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic. May contain the '+' and '#' wildcards.
    * @param callback The callback that will be called when a message with matching topic is received.
    * @param qos The MQTT quality of service. Defaults to 0.
    */
@@ -133,7 +133,7 @@ class MQTTComponent : public Component {
    *
    * If an invalid JSON payload is received, the callback will not be called.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic. May contain the '+' and '#' wildcards.
    * @param callback The callback with a parsed JsonObject that will be called when a message with matching topic is
    * received.
    * @param qos The MQTT quality of service. Defaults to 0.
@@ -180,8 +180,18 @@ class MQTTComponent : public Component {
 
   bool is_connected_() const;
 
-  /// Internal method to start sending discovery info, this will call send_discovery().
+  friend class MQTTClientComponent;
+
+  /** Internal method to send the discovery info, this will call send_discovery().
+   *
+   * The discovery topic is retained, so if the serialized payload is unchanged since it was last published,
+   * nothing is sent again.
+   *
+   * @return false if the backend could not accept the message (e.g. its buffer is full).
+   */
   bool send_discovery_();
+  /// Forget the last published discovery payload, so the next send_discovery_() call publishes it again.
+  void invalidate_discovery_();
 
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
@@ -195,6 +205,8 @@ class MQTTComponent : public Component {
   bool discovery_enabled_{true};
   std::unique_ptr<Availability> availability_;
   bool resend_state_{false};
+  /// Hash of the last published discovery payload, 0 if none.
+  uint32_t discovery_hash_{0};
 };
 
 }  // namespace mqtt
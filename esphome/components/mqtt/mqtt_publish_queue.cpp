@@ -0,0 +1,173 @@
+#include "mqtt_publish_queue.h"
+
+#ifdef USE_MQTT
+
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace mqtt {
+
+static const char *const TAG = "mqtt.queue";
+
+static const uint8_t FLAG_RETAIN = 1 << 0;
+static const uint8_t FLAG_DISCARDED = 1 << 1;
+static const uint8_t FLAG_WRAP = 1 << 2;
+
+MQTTPublishQueue::MQTTPublishQueue(size_t capacity) : capacity_(capacity) {
+  ExternalRAMAllocator<uint8_t> allocator(ExternalRAMAllocator<uint8_t>::ALLOW_FAILURE);
+  this->buffer_ = allocator.allocate(capacity);
+  if (this->buffer_ == nullptr) {
+    ESP_LOGE(TAG, "Could not allocate publish queue of %u bytes!", capacity);
+    this->capacity_ = 0;
+  }
+}
+
+bool MQTTPublishQueue::push(const MQTTMessage &message, size_t *evicted) {
+  if (evicted != nullptr)
+    *evicted = 0;
+  const size_t topic_length = message.topic.size() + 1;
+  const size_t size = sizeof(Header) + topic_length + message.payload.size();
+  if (size > this->capacity_ || topic_length > UINT16_MAX) {
+    this->dropped_++;
+    return false;
+  }
+
+  if (message.retain && this->discard_retained_(message.topic))
+    this->coalesced_++;
+
+  size_t offset;
+  while (!this->reserve_(size, &offset)) {
+    this->pop_record_();
+    this->dropped_++;
+    if (evicted != nullptr)
+      (*evicted)++;
+  }
+
+  Header header{
+      .payload_length = static_cast<uint32_t>(message.payload.size()),
+      .topic_length = static_cast<uint16_t>(topic_length),
+      .qos = message.qos,
+      .flags = static_cast<uint8_t>(message.retain ? FLAG_RETAIN : 0),
+  };
+  this->write_header_(offset, header);
+  uint8_t *data = this->buffer_ + offset + sizeof(Header);
+  memcpy(data, message.topic.c_str(), topic_length);
+  memcpy(data + topic_length, message.payload.data(), message.payload.size());
+
+  this->tail_ = offset + size;
+  this->records_++;
+  this->depth_++;
+  return true;
+}
+
+MQTTQueuedMessage MQTTPublishQueue::front() {
+  // the head record is never a discarded one, see pop_record_()
+  Header header = this->read_header_(this->head_);
+  const char *data = reinterpret_cast<const char *>(this->buffer_ + this->head_ + sizeof(Header));
+  return MQTTQueuedMessage{
+      .topic = data,
+      .payload = data + header.topic_length,
+      .payload_length = header.payload_length,
+      .qos = header.qos,
+      .retain = (header.flags & FLAG_RETAIN) != 0,
+  };
+}
+
+void MQTTPublishQueue::pop() {
+  if (!this->empty())
+    this->pop_record_();
+}
+
+MQTTPublishQueue::Header MQTTPublishQueue::read_header_(size_t offset) const {
+  Header header;
+  memcpy(&header, this->buffer_ + offset, sizeof(Header));
+  return header;
+}
+
+void MQTTPublishQueue::write_header_(size_t offset, const Header &header) {
+  memcpy(this->buffer_ + offset, &header, sizeof(Header));
+}
+
+size_t MQTTPublishQueue::resolve_(size_t offset) const {
+  if (this->capacity_ - offset < sizeof(Header))
+    return 0;
+  if (this->read_header_(offset).flags & FLAG_WRAP)
+    return 0;
+  return offset;
+}
+
+bool MQTTPublishQueue::reserve_(size_t size, size_t *offset) {
+  if (this->records_ == 0) {
+    this->head_ = this->tail_ = 0;
+    *offset = 0;
+    return size <= this->capacity_;
+  }
+
+  if (this->tail_ > this->head_) {
+    if (this->capacity_ - this->tail_ >= size) {
+      *offset = this->tail_;
+      return true;
+    }
+    if (this->head_ >= size) {
+      // continue at the start of the ring, tell the reader to do the same
+      if (this->capacity_ - this->tail_ >= sizeof(Header)) {
+        Header wrap{};
+        wrap.flags = FLAG_WRAP;
+        this->write_header_(this->tail_, wrap);
+      }
+      *offset = 0;
+      return true;
+    }
+    return false;
+  }
+
+  if (this->tail_ < this->head_ && this->head_ - this->tail_ >= size) {
+    *offset = this->tail_;
+    return true;
+  }
+  // tail_ == head_ with records in the ring means it's full
+  return false;
+}
+
+void MQTTPublishQueue::pop_record_() {
+  do {
+    Header header = this->read_header_(this->head_);
+    if ((header.flags & FLAG_DISCARDED) == 0)
+      this->depth_--;
+    this->head_ = this->resolve_(this->head_ + sizeof(Header) + header.topic_length + header.payload_length);
+    this->records_--;
+    // also release discarded records directly behind it, so the head is always a live message
+  } while (this->records_ != 0 && (this->read_header_(this->head_).flags & FLAG_DISCARDED) != 0);
+
+  if (this->records_ == 0)
+    this->head_ = this->tail_ = 0;
+}
+
+bool MQTTPublishQueue::discard_retained_(const std::string &topic) {
+  const size_t topic_length = topic.size() + 1;
+  size_t offset = this->head_;
+  for (size_t i = 0; i < this->records_; i++) {
+    Header header = this->read_header_(offset);
+    if ((header.flags & (FLAG_RETAIN | FLAG_DISCARDED)) == FLAG_RETAIN && header.topic_length == topic_length &&
+        memcmp(this->buffer_ + offset + sizeof(Header), topic.c_str(), topic_length) == 0) {
+      if (offset == this->head_) {
+        this->pop_record_();
+      } else {
+        header.flags |= FLAG_DISCARDED;
+        this->write_header_(offset, header);
+        this->depth_--;
+      }
+      return true;
+    }
+    offset = this->resolve_(offset + sizeof(Header) + header.topic_length + header.payload_length);
+  }
+  return false;
+}
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT
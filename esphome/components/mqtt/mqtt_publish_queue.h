@@ -0,0 +1,84 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_MQTT
+
+#include "mqtt_backend.h"
+
+namespace esphome {
+namespace mqtt {
+
+/// A message stored in the MQTTPublishQueue. The pointers are valid until the next push() or pop().
+struct MQTTQueuedMessage {
+  const char *topic;  ///< Null-terminated.
+  const char *payload;
+  size_t payload_length;
+  uint8_t qos;
+  bool retain;
+};
+
+/** Bounded FIFO of outbound MQTT messages, used to buffer publishes while the broker is unreachable.
+ *
+ * Messages are stored back to back in a single byte ring that is allocated once (in PSRAM if available), so
+ * queueing does not allocate. A retained message replaces any queued message for the same topic, as only the
+ * last value matters to the broker; all other messages keep their order. When the ring is full, the oldest
+ * messages are dropped to make room.
+ */
+class MQTTPublishQueue {
+ public:
+  explicit MQTTPublishQueue(size_t capacity);
+
+  /** Queue a message, returns false if it is larger than the whole queue.
+   *
+   * If evicted is given, it is set to the number of older messages that were dropped to make room.
+   */
+  bool push(const MQTTMessage &message, size_t *evicted = nullptr);
+  bool empty() const { return this->records_ == 0; }
+  /// The oldest queued message, the queue must not be empty.
+  MQTTQueuedMessage front();
+  /// Remove the oldest queued message.
+  void pop();
+
+  size_t get_capacity() const { return this->capacity_; }
+  /// Number of messages waiting to be sent.
+  size_t get_depth() const { return this->depth_; }
+  /// Number of messages dropped because the queue was full.
+  uint32_t get_dropped() const { return this->dropped_; }
+  /// Number of retained messages replaced by a newer value for the same topic.
+  uint32_t get_coalesced() const { return this->coalesced_; }
+
+ protected:
+  struct Header {
+    uint32_t payload_length;
+    uint16_t topic_length;  ///< Including the null terminator.
+    uint8_t qos;
+    uint8_t flags;
+  };
+
+  Header read_header_(size_t offset) const;
+  void write_header_(size_t offset, const Header &header);
+  /// Offset of the next record at or after offset, following wrap markers.
+  size_t resolve_(size_t offset) const;
+  /// Find a contiguous free region of size bytes, returns false if there is none.
+  bool reserve_(size_t size, size_t *offset);
+  /// Remove the oldest message, along with any discarded records following it.
+  void pop_record_();
+  /// Mark a queued retained message for topic as discarded.
+  bool discard_retained_(const std::string &topic);
+
+  uint8_t *buffer_;
+  size_t capacity_;
+  size_t head_{0};
+  size_t tail_{0};
+  /// Number of records in the ring, including discarded ones.
+  size_t records_{0};
+  size_t depth_{0};
+  uint32_t dropped_{0};
+  uint32_t coalesced_{0};
+};
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT
@@ -0,0 +1,100 @@
+#include "mqtt_topic_trie.h"
+
+#ifdef USE_MQTT
+
+#include "esphome/core/helpers.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace mqtt {
+
+void MQTTTopicTrie::insert(const std::string &filter, size_t index) {
+  Node *node = &this->root_;
+  const char *level = filter.c_str();
+  while (true) {
+    const char *end = level;
+    while (*end != '\0' && *end != '/')
+      end++;
+    size_t len = end - level;
+
+    if (len == 1 && *level == '#') {
+      // MQTT mandates that '#' is the last level of a filter
+      node->multi_wildcard.push_back(index);
+      return;
+    }
+    if (len == 1 && *level == '+') {
+      if (!node->single_wildcard)
+        node->single_wildcard = make_unique<Node>();
+      node = node->single_wildcard.get();
+    } else {
+      node = get_or_create_child_(node, level, len);
+    }
+
+    if (*end == '\0')
+      break;
+    level = end + 1;
+  }
+  node->exact.push_back(index);
+}
+
+void MQTTTopicTrie::clear() {
+  this->root_.children.clear();
+  this->root_.single_wildcard.reset();
+  this->root_.exact.clear();
+  this->root_.multi_wildcard.clear();
+}
+
+void MQTTTopicTrie::match(const char *topic, std::vector<size_t> &matches) const {
+  // MQTT spec mandates that topics must not be empty
+  if (*topic == '\0')
+    return;
+  match_(&this->root_, topic, true, matches);
+}
+
+MQTTTopicTrie::Node *MQTTTopicTrie::get_or_create_child_(Node *node, const char *level, size_t len) {
+  for (auto &child : node->children) {
+    if (child->level.size() == len && memcmp(child->level.data(), level, len) == 0)
+      return child.get();
+  }
+  node->children.push_back(make_unique<Node>());
+  Node *child = node->children.back().get();
+  child->level.assign(level, len);
+  return child;
+}
+
+void MQTTTopicTrie::match_(const Node *node, const char *level, bool first, std::vector<size_t> &matches) {
+  // topics beginning with '$' are not matched by wildcards in the first level
+  const bool wildcards = !first || *level != '$';
+  if (wildcards)
+    matches.insert(matches.end(), node->multi_wildcard.begin(), node->multi_wildcard.end());
+
+  const char *end = level;
+  while (*end != '\0' && *end != '/')
+    end++;
+  const size_t len = end - level;
+
+  auto descend = [&](const Node *child) {
+    if (*end != '\0') {
+      match_(child, end + 1, false, matches);
+      return;
+    }
+    // last level, "a/#" also matches the parent level "a"
+    matches.insert(matches.end(), child->exact.begin(), child->exact.end());
+    matches.insert(matches.end(), child->multi_wildcard.begin(), child->multi_wildcard.end());
+  };
+
+  for (const auto &child : node->children) {
+    if (child->level.size() == len && memcmp(child->level.data(), level, len) == 0) {
+      descend(child.get());
+      break;
+    }
+  }
+  if (wildcards && node->single_wildcard)
+    descend(node->single_wildcard.get());
+}
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT
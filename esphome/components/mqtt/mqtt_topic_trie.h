@@ -0,0 +1,56 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_MQTT
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace mqtt {
+
+/** Trie of MQTT subscription filters, split on the '/' level separator.
+ *
+ * Filters are inserted once at subscribe time together with an opaque index (the position of the
+ * subscription in MQTTClientComponent). Matching an inbound topic then walks the topic levels in place
+ * without allocating, so dispatch cost scales with the topic depth instead of the number of subscriptions.
+ *
+ * Supports the '+' (single level) and '#' (multi level) wildcards, including the rule that wildcards in
+ * the first level don't match topics starting with '$'.
+ */
+class MQTTTopicTrie {
+ public:
+  /// Register a subscription filter under the given index.
+  void insert(const std::string &filter, size_t index);
+  /// Remove all filters.
+  void clear();
+  /** Collect the indices of all filters matching the given topic.
+   *
+   * @param topic The message topic, must not contain wildcards.
+   * @param matches Output vector, indices are appended in no particular order.
+   */
+  void match(const char *topic, std::vector<size_t> &matches) const;
+
+ protected:
+  struct Node {
+    std::string level;
+    std::vector<std::unique_ptr<Node>> children;
+    std::unique_ptr<Node> single_wildcard;
+    /// Filters that end on this node.
+    std::vector<size_t> exact;
+    /// Filters that end with a '#' directly below this node.
+    std::vector<size_t> multi_wildcard;
+  };
+
+  static Node *get_or_create_child_(Node *node, const char *level, size_t len);
+  static void match_(const Node *node, const char *level, bool first, std::vector<size_t> &matches);
+
+  Node root_;
+};
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT
@@ -3,6 +3,7 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import automation
 from esphome.const import (
+    CONF_BUFFER_SIZE,
     CONF_ID,
     CONF_NUM_ATTEMPTS,
     CONF_PASSWORD,
@@ -45,6 +46,9 @@ CONFIG_SCHEMA = cv.Schema(
             CONF_REBOOT_TIMEOUT, default="5min"
         ): cv.positive_time_period_milliseconds,
         cv.Optional(CONF_NUM_ATTEMPTS, default="10"): cv.positive_not_null_int,
+        cv.SplitDefault(
+            CONF_BUFFER_SIZE, esp8266="1kB", esp32="4kB", rp2040="4kB"
+        ): cv.All(cv.validate_bytes, cv.int_range(min=256, max=65536)),
         cv.Optional(CONF_ON_STATE_CHANGE): automation.validate_automation(
             {
                 cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(OTAStateChangeTrigger),
@@ -78,6 +82,7 @@ CONFIG_SCHEMA = cv.Schema(
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     cg.add(var.set_port(config[CONF_PORT]))
+    cg.add(var.set_buffer_size(config[CONF_BUFFER_SIZE]))
     cg.add_define("USE_OTA")
     if CONF_PASSWORD in config:
         cg.add(var.set_auth_password(config[CONF_PASSWORD]))
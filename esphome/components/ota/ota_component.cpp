@@ -4,6 +4,9 @@
 #include "ota_backend_arduino_esp8266.h"
 #include "ota_backend_arduino_rp2040.h"
 #include "ota_backend_esp_idf.h"
+#include "ota_decompressor.h"
+#include "ota_delta.h"
+#include "ota_writer.h"
 
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
@@ -14,6 +17,8 @@
 
 #include <cerrno>
 #include <cstdio>
+#include <cstring>
+#include <new>
 
 namespace esphome {
 namespace ota {
@@ -22,6 +27,15 @@ static const char *const TAG = "ota";
 
 static const uint8_t OTA_VERSION_1_0 = 1;
 
+/// How long to wait for the client to pick the update mode, it computes the delta in the meantime.
+static const uint32_t OTA_MODE_TIMEOUT = 30000;
+
+#if defined(USE_ESP32) || defined(USE_RP2040)
+static const uint8_t OTA_INFLATE_WINDOW_BITS = 15;
+#else
+static const uint8_t OTA_INFLATE_WINDOW_BITS = 12;
+#endif
+
 OTAComponent *global_ota_component = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 std::unique_ptr<OTABackend> make_ota_backend() {
@@ -92,6 +106,7 @@ void OTAComponent::setup() {
 void OTAComponent::dump_config() {
   ESP_LOGCONFIG(TAG, "Over-The-Air Updates:");
   ESP_LOGCONFIG(TAG, "  Address: %s:%u", network::get_use_address().c_str(), this->port_);
+  ESP_LOGCONFIG(TAG, "  Buffer Size: %u bytes", this->buffer_size_);
 #ifdef USE_OTA_PASSWORD
   if (!this->password_.empty()) {
     ESP_LOGCONFIG(TAG, "  Using Password.");
@@ -116,6 +131,8 @@ void OTAComponent::loop() {
 }
 
 static const uint8_t FEATURE_SUPPORTS_COMPRESSION = 0x01;
+static const uint8_t FEATURE_SUPPORTS_DELTA = 0x02;
+static const uint8_t FEATURE_SUPPORTS_DEFLATE = 0x04;
 
 void OTAComponent::handle_() {
   OTAResponseTypes error_code = OTA_RESPONSE_ERROR_UNKNOWN;
@@ -126,7 +143,16 @@ void OTAComponent::handle_() {
   char *sbuf = reinterpret_cast<char *>(buf);
   size_t ota_size;
   uint8_t ota_features;
+  uint8_t device_features = 0;
+  uint8_t mode = 0;
+  size_t base_size = 0;
+  size_t transfer_size;
   std::unique_ptr<OTABackend> backend;
+  std::unique_ptr<OTAWriter> writer;
+  std::unique_ptr<OTADecompressor> decompressor;
+  std::unique_ptr<OTADeltaPatcher> patcher;
+  uint32_t start_time;
+  uint32_t elapsed;
   (void) ota_features;
 
   if (client_ == nullptr) {
@@ -177,14 +203,38 @@ void OTAComponent::handle_() {
   ota_features = buf[0];  // NOLINT
   ESP_LOGV(TAG, "OTA features is 0x%02X", ota_features);
 
-  // Acknowledge header - 1 byte
-  buf[0] = OTA_RESPONSE_HEADER_OK;
-  if ((ota_features & FEATURE_SUPPORTS_COMPRESSION) != 0 && backend->supports_compression()) {
-    buf[0] = OTA_RESPONSE_SUPPORTS_COMPRESSION;
+  if ((ota_features & (FEATURE_SUPPORTS_DELTA | FEATURE_SUPPORTS_DEFLATE)) != 0) {
+    // Acknowledge header with the features of this device - 2 bytes, plus the deflate window bits if supported. Only
+    // clients that know delta updates or deflate expect this
+    if (backend->supports_compression()) {
+      // the backend takes the gzip compressed image as is
+      device_features |= FEATURE_SUPPORTS_COMPRESSION;
+    } else if ((ota_features & FEATURE_SUPPORTS_DEFLATE) != 0) {
+      decompressor = make_unique<OTAInflater>(OTA_INFLATE_WINDOW_BITS);
+      if (decompressor->init()) {
+        device_features |= FEATURE_SUPPORTS_DEFLATE;
+      } else {
+        decompressor = nullptr;
+      }
+    }
+    if ((ota_features & FEATURE_SUPPORTS_DELTA) != 0) {
+      base_size = delta_base_size();
+      if (base_size != 0)
+        device_features |= FEATURE_SUPPORTS_DELTA;
+    }
+    buf[0] = OTA_RESPONSE_FEATURES;
+    buf[1] = device_features;
+    buf[2] = OTA_INFLATE_WINDOW_BITS;
+    this->writeall_(buf, (device_features & FEATURE_SUPPORTS_DEFLATE) != 0 ? 3 : 2);
+  } else {
+    // Acknowledge header - 1 byte
+    buf[0] = OTA_RESPONSE_HEADER_OK;
+    if ((ota_features & FEATURE_SUPPORTS_COMPRESSION) != 0 && backend->supports_compression()) {
+      buf[0] = OTA_RESPONSE_SUPPORTS_COMPRESSION;
+    }
+    this->writeall_(buf, 1);
   }
 
-  this->writeall_(buf, 1);
-
 #ifdef USE_OTA_PASSWORD
   if (!this->password_.empty()) {
     buf[0] = OTA_RESPONSE_REQUEST_AUTH;
@@ -248,6 +298,25 @@ void OTAComponent::handle_() {
   buf[0] = OTA_RESPONSE_AUTH_OK;
   this->writeall_(buf, 1);
 
+  if ((device_features & (FEATURE_SUPPORTS_DELTA | FEATURE_SUPPORTS_DEFLATE)) != 0) {
+    if ((device_features & FEATURE_SUPPORTS_DELTA) != 0 && !this->send_delta_signature_(base_size)) {
+      ESP_LOGW(TAG, "Sending delta signature failed!");
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    // Read update mode, the features used for this update - 1 byte
+    if (!this->readall_(buf, 1, OTA_MODE_TIMEOUT)) {
+      ESP_LOGW(TAG, "Reading update mode failed!");
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    mode = buf[0];
+    if ((mode & ~(device_features & (FEATURE_SUPPORTS_DELTA | FEATURE_SUPPORTS_DEFLATE))) != 0) {
+      ESP_LOGW(TAG, "Invalid update mode 0x%02X", mode);
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    if ((mode & FEATURE_SUPPORTS_DEFLATE) == 0)
+      decompressor = nullptr;
+  }
+
   // Read size, 4 bytes MSB first
   if (!this->readall_(buf, 4)) {
     ESP_LOGW(TAG, "Reading size failed!");
@@ -282,10 +351,48 @@ void OTAComponent::handle_() {
   buf[0] = OTA_RESPONSE_BIN_MD5_OK;
   this->writeall_(buf, 1);
 
-  while (total < ota_size) {
+  transfer_size = ota_size;
+  if (mode != 0) {
+    // Read the size of the delta patch or compressed image, 4 bytes MSB first
+    if (!this->readall_(buf, 4)) {
+      ESP_LOGW(TAG, "Reading transfer size failed!");
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    transfer_size = encode_uint32(buf[0], buf[1], buf[2], buf[3]);
+    ESP_LOGD(TAG, "Receiving %u bytes (delta: %s, compressed: %s)", transfer_size,
+             YESNO((mode & FEATURE_SUPPORTS_DELTA) != 0), YESNO((mode & FEATURE_SUPPORTS_DEFLATE) != 0));
+  }
+
+  writer = make_unique<OTAWriter>(backend.get(), this->buffer_size_);
+  if (!writer->init()) {
+    ESP_LOGW(TAG, "Starting the writer failed!");
+    goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+  }
+  if ((mode & FEATURE_SUPPORTS_DELTA) != 0)
+    patcher = make_unique<OTADeltaPatcher>(writer.get(), base_size, ota_size);
+  if (decompressor != nullptr) {
+    OTADeltaPatcher *output_patcher = patcher.get();
+    OTAWriter *output_writer = writer.get();
+    decompressor->set_output([output_patcher, output_writer](const uint8_t *data, size_t len) {
+      return output_patcher != nullptr ? output_patcher->feed(data, len) : output_writer->append(data, len);
+    });
+  }
+
+  start_time = millis();
+  while (total < transfer_size) {
     // TODO: timeout check
-    size_t requested = std::min(sizeof(buf), ota_size - total);
-    ssize_t read = this->client_->read(buf, requested);
+    uint8_t *target;
+    size_t requested;
+    if (mode != 0) {
+      // the stream is read into the stack buffer, the decompressor or patcher fill the writer's chunks
+      target = buf;
+      requested = std::min(sizeof(buf), transfer_size - total);
+    } else {
+      size_t space;
+      target = writer->reserve(&space);
+      requested = std::min(space, ota_size - total);
+    }
+    ssize_t read = this->client_->read(target, requested);
     if (read == -1) {
       if (errno == EAGAIN || errno == EWOULDBLOCK) {
         App.feed_wdt();
@@ -302,17 +409,23 @@ void OTAComponent::handle_() {
       goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
     }
 
-    error_code = backend->write(buf, read);
+    total += read;
+    if (decompressor != nullptr) {
+      error_code = decompressor->feed(buf, read);
+    } else if (patcher != nullptr) {
+      error_code = patcher->feed(buf, read);
+    } else {
+      error_code = writer->commit(read);
+    }
     if (error_code != OTA_RESPONSE_OK) {
       ESP_LOGW(TAG, "Error writing binary data to flash!, error_code: %d", error_code);
       goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
     }
-    total += read;
 
     uint32_t now = millis();
     if (now - last_progress > 1000) {
       last_progress = now;
-      float percentage = (total * 100.0f) / ota_size;
+      float percentage = (total * 100.0f) / transfer_size;
       ESP_LOGD(TAG, "OTA in progress: %0.1f%%", percentage);
 #ifdef USE_OTA_STATE_CALLBACK
       this->state_callback_.call(OTA_IN_PROGRESS, percentage, 0);
@@ -323,6 +436,31 @@ void OTAComponent::handle_() {
     }
   }
 
+  if (decompressor != nullptr) {
+    error_code = decompressor->finish();
+    if (error_code != OTA_RESPONSE_OK) {
+      ESP_LOGW(TAG, "Error decompressing update!, error_code: %d", error_code);
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    decompressor = nullptr;
+  }
+  if (patcher != nullptr) {
+    error_code = patcher->finish();
+    if (error_code != OTA_RESPONSE_OK) {
+      ESP_LOGW(TAG, "Error applying delta update!, error_code: %d", error_code);
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    patcher = nullptr;
+  }
+  error_code = writer->flush();
+  if (error_code != OTA_RESPONSE_OK) {
+    ESP_LOGW(TAG, "Error writing binary data to flash!, error_code: %d", error_code);
+    goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+  }
+  writer = nullptr;
+  elapsed = std::max<uint32_t>(millis() - start_time, 1);
+  ESP_LOGI(TAG, "Received %u bytes in %.1fs (%.1f KB/s)", total, elapsed / 1000.0f, total / 1.024f / elapsed);
+
   // Acknowledge receive OK - 1 byte
   buf[0] = OTA_RESPONSE_RECEIVE_OK;
   this->writeall_(buf, 1);
@@ -360,6 +498,10 @@ error:
   this->client_->close();
   this->client_ = nullptr;
 
+  // stop writing before aborting the update
+  decompressor = nullptr;
+  patcher = nullptr;
+  writer = nullptr;
   if (backend != nullptr && update_started) {
     backend->abort();
   }
@@ -370,12 +512,12 @@ error:
 #endif
 }
 
-bool OTAComponent::readall_(uint8_t *buf, size_t len) {
+bool OTAComponent::readall_(uint8_t *buf, size_t len, uint32_t timeout) {
   uint32_t start = millis();
   uint32_t at = 0;
   while (len - at > 0) {
     uint32_t now = millis();
-    if (now - start > 1000) {
+    if (now - start > timeout) {
       ESP_LOGW(TAG, "Timed out reading %d bytes of data", len);
       return false;
     }
@@ -429,6 +571,50 @@ bool OTAComponent::writeall_(const uint8_t *buf, size_t len) {
   return true;
 }
 
+bool OTAComponent::send_delta_signature_(size_t base_size) {
+  // Block size and base size, 4 bytes MSB first each
+  uint8_t header[9] = {OTA_RESPONSE_DELTA_SIGNATURE};
+  for (uint8_t i = 0; i < 4; i++) {
+    header[1 + i] = DELTA_BLOCK_SIZE >> (24 - i * 8);
+    header[5 + i] = base_size >> (24 - i * 8);
+  }
+  if (!this->writeall_(header, sizeof(header)))
+    return false;
+
+  std::unique_ptr<uint8_t[]> block(new (std::nothrow) uint8_t[DELTA_BLOCK_SIZE]);  // NOLINT
+  if (block == nullptr)
+    return false;
+  // Per block the weak checksum (4 bytes MSB first) and the first 8 bytes of the MD5, sent in batches
+  static const size_t ENTRY_SIZE = 12;
+  uint8_t entries[ENTRY_SIZE * 16];
+  size_t entries_len = 0;
+  md5::MD5Digest md5{};
+  uint8_t digest[16];
+  for (size_t offset = 0; offset < base_size; offset += DELTA_BLOCK_SIZE) {
+    const size_t len = std::min<size_t>(DELTA_BLOCK_SIZE, base_size - offset);
+    if (!delta_base_read(offset, block.get(), len))
+      return false;
+    const uint32_t weak = delta_weak_checksum(block.get(), len);
+    md5.init();
+    md5.add(block.get(), len);
+    md5.calculate();
+    md5.get_bytes(digest);
+
+    uint8_t *entry = entries + entries_len;
+    for (uint8_t i = 0; i < 4; i++)
+      entry[i] = weak >> (24 - i * 8);
+    memcpy(entry + 4, digest, 8);
+    entries_len += ENTRY_SIZE;
+    if (entries_len == sizeof(entries) || offset + len == base_size) {
+      if (!this->writeall_(entries, entries_len))
+        return false;
+      entries_len = 0;
+    }
+    App.feed_wdt();
+  }
+  return true;
+}
+
 float OTAComponent::get_setup_priority() const { return setup_priority::AFTER_WIFI; }
 uint16_t OTAComponent::get_port() const { return this->port_; }
 void OTAComponent::set_port(uint16_t port) { this->port_ = port; }
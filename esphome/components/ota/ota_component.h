@@ -20,6 +20,8 @@ enum OTAResponseTypes {
   OTA_RESPONSE_RECEIVE_OK = 68,
   OTA_RESPONSE_UPDATE_END_OK = 69,
   OTA_RESPONSE_SUPPORTS_COMPRESSION = 70,
+  OTA_RESPONSE_FEATURES = 71,
+  OTA_RESPONSE_DELTA_SIGNATURE = 72,
 
   OTA_RESPONSE_ERROR_MAGIC = 128,
   OTA_RESPONSE_ERROR_UPDATE_PREPARE = 129,
@@ -34,6 +36,8 @@ enum OTAResponseTypes {
   OTA_RESPONSE_ERROR_NO_UPDATE_PARTITION = 138,
   OTA_RESPONSE_ERROR_MD5_MISMATCH = 139,
   OTA_RESPONSE_ERROR_RP2040_NOT_ENOUGH_SPACE = 140,
+  OTA_RESPONSE_ERROR_DELTA_INVALID = 141,
+  OTA_RESPONSE_ERROR_DECOMPRESSION = 142,
   OTA_RESPONSE_ERROR_UNKNOWN = 255,
 };
 
@@ -49,6 +53,8 @@ class OTAComponent : public Component {
 
   /// Manually set the port OTA should listen on.
   void set_port(uint16_t port);
+  /// Set the size of the chunks the image is received in and written to flash, two of them are allocated on ESP32.
+  void set_buffer_size(size_t buffer_size) { this->buffer_size_ = buffer_size; }
 
   bool should_enter_safe_mode(uint8_t num_attempts, uint32_t enable_time);
 
@@ -78,14 +84,17 @@ class OTAComponent : public Component {
   uint32_t read_rtc_();
 
   void handle_();
-  bool readall_(uint8_t *buf, size_t len);
+  bool readall_(uint8_t *buf, size_t len, uint32_t timeout = 1000);
   bool writeall_(const uint8_t *buf, size_t len);
+  /// Send the checksums of the blocks of the running image that a delta update can be computed against.
+  bool send_delta_signature_(size_t base_size);
 
 #ifdef USE_OTA_PASSWORD
   std::string password_;
 #endif  // USE_OTA_PASSWORD
 
   uint16_t port_;
+  size_t buffer_size_{1024};
 
   std::unique_ptr<socket::Socket> server_;
   std::unique_ptr<socket::Socket> client_;
@@ -0,0 +1,350 @@
+#include "ota_decompressor.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace esphome {
+namespace ota {
+
+static const char *const TAG = "ota.inflate";
+
+static const uint16_t LENGTH_BASE[29] = {3,  4,  5,  6,  7,  8,  9,  10,  11,  13,  15,  17,  19, 23, 27,
+                                         31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                         2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DISTANCE_BASE[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                           33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                           1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+/// Order in which the lengths of the code length code are sent.
+static const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+bool OTAInflater::init() {
+  this->window_.reset(new (std::nothrow) uint8_t[this->window_size_]);  // NOLINT(cppcoreguidelines-owning-memory)
+  this->input_.reset(new (std::nothrow) uint8_t[INPUT_SIZE]);           // NOLINT(cppcoreguidelines-owning-memory)
+  if (this->window_ == nullptr || this->input_ == nullptr) {
+    ESP_LOGW(TAG, "Could not allocate %u bytes for the window", this->window_size_);
+    return false;
+  }
+  return true;
+}
+
+OTAResponseTypes OTAInflater::feed(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    if (this->state_ == State::DONE) {
+      // nothing can follow the last block
+      return OTA_RESPONSE_OK;
+    }
+    // keep the input of the item that is not decoded yet and append as much new input as fits
+    memmove(this->input_.get(), this->input_.get() + this->input_pos_, this->input_len_ - this->input_pos_);
+    this->input_len_ -= this->input_pos_;
+    this->input_pos_ = 0;
+    const size_t count = std::min(INPUT_SIZE - this->input_len_, len);
+    if (count == 0) {
+      ESP_LOGW(TAG, "Item at output offset %u does not fit into the input buffer", this->total_out_);
+      return OTA_RESPONSE_ERROR_DECOMPRESSION;
+    }
+    memcpy(this->input_.get() + this->input_len_, data, count);
+    this->input_len_ += count;
+    data += count;
+    len -= count;
+
+    const Result result = this->inflate_();
+    OTAResponseTypes error = this->emit_();
+    if (error != OTA_RESPONSE_OK)
+      return error;
+    if (result == Result::INVALID) {
+      ESP_LOGW(TAG, "Invalid compressed data at output offset %u", this->total_out_);
+      return OTA_RESPONSE_ERROR_DECOMPRESSION;
+    }
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes OTAInflater::finish() {
+  if (this->state_ != State::DONE) {
+    ESP_LOGW(TAG, "Compressed data ends after %u bytes of output", this->total_out_);
+    return OTA_RESPONSE_ERROR_DECOMPRESSION;
+  }
+  return this->emit_();
+}
+
+OTAInflater::Result OTAInflater::inflate_() {
+  while (this->state_ != State::DONE && this->output_error_ == OTA_RESPONSE_OK) {
+    // remember where the item starts, to decode it again once more input arrived
+    const size_t input_pos = this->input_pos_;
+    const uint32_t bit_buffer = this->bit_buffer_;
+    const uint8_t bit_count = this->bit_count_;
+
+    Result result;
+    switch (this->state_) {
+      case State::HEADER:
+        result = this->header_();
+        break;
+      case State::STORED:
+        result = this->stored_();
+        break;
+      default:
+        result = this->codes_();
+        break;
+    }
+    if (result == Result::NEED_INPUT) {
+      this->input_pos_ = input_pos;
+      this->bit_buffer_ = bit_buffer;
+      this->bit_count_ = bit_count;
+      this->underflow_ = false;
+      return result;
+    }
+    if (result == Result::INVALID)
+      return result;
+  }
+  return Result::OK;
+}
+
+OTAInflater::Result OTAInflater::header_() {
+  const bool last = this->bits_(1) != 0;
+  const uint32_t type = this->bits_(2);
+  if (this->underflow_)
+    return Result::NEED_INPUT;
+
+  switch (type) {
+    case 0: {
+      // stored block, starts at the next byte boundary
+      this->bit_buffer_ = 0;
+      this->bit_count_ = 0;
+      if (this->input_len_ - this->input_pos_ < 4)
+        return Result::NEED_INPUT;
+      const uint8_t *header = this->input_.get() + this->input_pos_;
+      const uint16_t length = encode_uint16(header[1], header[0]);
+      const uint16_t inverted = encode_uint16(header[3], header[2]);
+      if (length != static_cast<uint16_t>(~inverted))
+        return Result::INVALID;
+      this->input_pos_ += 4;
+      this->stored_remaining_ = length;
+      this->state_ = length != 0 ? State::STORED : (last ? State::DONE : State::HEADER);
+      break;
+    }
+    case 1:
+      this->fixed_tables_();
+      this->state_ = State::CODES;
+      break;
+    case 2: {
+      const Result result = this->dynamic_header_();
+      if (result != Result::OK)
+        return result;
+      this->state_ = State::CODES;
+      break;
+    }
+    default:
+      return Result::INVALID;
+  }
+  this->last_block_ = last;
+  return Result::OK;
+}
+
+OTAInflater::Result OTAInflater::dynamic_header_() {
+  const uint16_t length_count = this->bits_(5) + 257;
+  const uint16_t distance_count = this->bits_(5) + 1;
+  const uint8_t code_length_count = this->bits_(4) + 4;
+  if (this->underflow_)
+    return Result::NEED_INPUT;
+  if (length_count > 286 || distance_count > MAX_DISTANCE_CODES)
+    return Result::INVALID;
+
+  uint8_t lengths[286 + MAX_DISTANCE_CODES];
+  for (uint8_t i = 0; i < 19; i++)
+    lengths[CODE_LENGTH_ORDER[i]] = i < code_length_count ? this->bits_(3) : 0;
+  if (this->underflow_)
+    return Result::NEED_INPUT;
+  uint16_t code_length_symbols[19];
+  Huffman code_lengths{{}, code_length_symbols};
+  if (!build_(&code_lengths, lengths, 19))
+    return Result::INVALID;
+
+  const uint16_t total = length_count + distance_count;
+  uint16_t index = 0;
+  while (index < total) {
+    const int symbol = this->decode_(&code_lengths);
+    if (symbol < 0)
+      return this->underflow_ ? Result::NEED_INPUT : Result::INVALID;
+    if (symbol < 16) {
+      lengths[index++] = symbol;
+      continue;
+    }
+    uint8_t length = 0;
+    uint32_t repeat;
+    if (symbol == 16) {
+      if (index == 0)
+        return Result::INVALID;
+      length = lengths[index - 1];
+      repeat = 3 + this->bits_(2);
+    } else if (symbol == 17) {
+      repeat = 3 + this->bits_(3);
+    } else {
+      repeat = 11 + this->bits_(7);
+    }
+    if (this->underflow_)
+      return Result::NEED_INPUT;
+    if (index + repeat > total)
+      return Result::INVALID;
+    while (repeat-- > 0)
+      lengths[index++] = length;
+  }
+
+  // without an end of block code the block could never end
+  if (lengths[256] == 0)
+    return Result::INVALID;
+  if (!build_(&this->lengths_, lengths, length_count) ||
+      !build_(&this->distances_, lengths + length_count, distance_count))
+    return Result::INVALID;
+  return Result::OK;
+}
+
+OTAInflater::Result OTAInflater::codes_() {
+  int symbol = this->decode_(&this->lengths_);
+  if (symbol < 0)
+    return this->underflow_ ? Result::NEED_INPUT : Result::INVALID;
+  if (symbol < 256) {
+    this->put_(symbol);
+    return Result::OK;
+  }
+  if (symbol == 256) {
+    this->state_ = this->last_block_ ? State::DONE : State::HEADER;
+    return Result::OK;
+  }
+
+  symbol -= 257;
+  if (symbol >= 29)
+    return Result::INVALID;
+  const uint16_t length = LENGTH_BASE[symbol] + this->bits_(LENGTH_EXTRA[symbol]);
+  symbol = this->decode_(&this->distances_);
+  if (symbol < 0)
+    return this->underflow_ ? Result::NEED_INPUT : Result::INVALID;
+  if (symbol >= MAX_DISTANCE_CODES)
+    return Result::INVALID;
+  const size_t distance = DISTANCE_BASE[symbol] + this->bits_(DISTANCE_EXTRA[symbol]);
+  if (this->underflow_)
+    return Result::NEED_INPUT;
+  if (distance > this->total_out_ || distance > this->window_size_)
+    return Result::INVALID;
+
+  // byte by byte, the copy may overlap its own output
+  const size_t mask = this->window_size_ - 1;
+  size_t from = (this->window_pos_ + this->window_size_ - distance) & mask;
+  for (uint16_t i = 0; i < length; i++) {
+    this->put_(this->window_[from]);
+    from = (from + 1) & mask;
+  }
+  return Result::OK;
+}
+
+OTAInflater::Result OTAInflater::stored_() {
+  const size_t count = std::min<size_t>(this->stored_remaining_, this->input_len_ - this->input_pos_);
+  if (count == 0)
+    return Result::NEED_INPUT;
+  for (size_t i = 0; i < count; i++)
+    this->put_(this->input_[this->input_pos_ + i]);
+  this->input_pos_ += count;
+  this->stored_remaining_ -= count;
+  if (this->stored_remaining_ == 0)
+    this->state_ = this->last_block_ ? State::DONE : State::HEADER;
+  return Result::OK;
+}
+
+void OTAInflater::fixed_tables_() {
+  uint8_t lengths[MAX_LENGTH_CODES];
+  memset(lengths, 8, 144);
+  memset(lengths + 144, 9, 256 - 144);
+  memset(lengths + 256, 7, 280 - 256);
+  memset(lengths + 280, 8, MAX_LENGTH_CODES - 280);
+  build_(&this->lengths_, lengths, MAX_LENGTH_CODES);
+  memset(lengths, 5, MAX_DISTANCE_CODES);
+  build_(&this->distances_, lengths, MAX_DISTANCE_CODES);
+}
+
+bool OTAInflater::build_(Huffman *huffman, const uint8_t *lengths, uint16_t count) {
+  memset(huffman->count, 0, sizeof(huffman->count));
+  for (uint16_t symbol = 0; symbol < count; symbol++)
+    huffman->count[lengths[symbol]]++;
+
+  // incomplete codes are fine, decode_() fails on the codes that are missing
+  int left = 1;
+  for (uint8_t len = 1; len <= MAX_BITS; len++) {
+    left <<= 1;
+    left -= huffman->count[len];
+    if (left < 0)
+      return false;
+  }
+
+  uint16_t offsets[MAX_BITS + 1];
+  offsets[1] = 0;
+  for (uint8_t len = 1; len < MAX_BITS; len++)
+    offsets[len + 1] = offsets[len] + huffman->count[len];
+  for (uint16_t symbol = 0; symbol < count; symbol++) {
+    if (lengths[symbol] != 0)
+      huffman->symbol[offsets[lengths[symbol]]++] = symbol;
+  }
+  return true;
+}
+
+int OTAInflater::decode_(const Huffman *huffman) {
+  // codes of each length are consecutive, first is the first code of the current length
+  int code = 0, first = 0, index = 0;
+  for (uint8_t len = 1; len <= MAX_BITS; len++) {
+    code |= this->bits_(1);
+    if (this->underflow_)
+      return -1;
+    const int count = huffman->count[len];
+    if (code - count < first)
+      return huffman->symbol[index + (code - first)];
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  }
+  return -1;
+}
+
+uint32_t OTAInflater::bits_(uint8_t count) {
+  while (this->bit_count_ < count) {
+    if (this->input_pos_ == this->input_len_) {
+      this->underflow_ = true;
+      return 0;
+    }
+    this->bit_buffer_ |= static_cast<uint32_t>(this->input_[this->input_pos_++]) << this->bit_count_;
+    this->bit_count_ += 8;
+  }
+  const uint32_t value = this->bit_buffer_ & ((uint32_t(1) << count) - 1);
+  this->bit_buffer_ >>= count;
+  this->bit_count_ -= count;
+  return value;
+}
+
+void OTAInflater::put_(uint8_t byte) {
+  this->window_[this->window_pos_++] = byte;
+  this->total_out_++;
+  if (this->window_pos_ == this->window_size_) {
+    // pass on the end of the ring before it gets overwritten
+    if (this->output_error_ == OTA_RESPONSE_OK) {
+      this->output_error_ =
+          this->output_(this->window_.get() + this->emitted_pos_, this->window_size_ - this->emitted_pos_);
+    }
+    this->window_pos_ = 0;
+    this->emitted_pos_ = 0;
+  }
+}
+
+OTAResponseTypes OTAInflater::emit_() {
+  if (this->output_error_ == OTA_RESPONSE_OK && this->window_pos_ > this->emitted_pos_) {
+    this->output_error_ =
+        this->output_(this->window_.get() + this->emitted_pos_, this->window_pos_ - this->emitted_pos_);
+    this->emitted_pos_ = this->window_pos_;
+  }
+  return this->output_error_;
+}
+
+}  // namespace ota
+}  // namespace esphome
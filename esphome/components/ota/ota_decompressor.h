@@ -0,0 +1,112 @@
+#pragma once
+
+#include "ota_component.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace esphome {
+namespace ota {
+
+/// Decompresses the transferred stream between the socket and the writer or delta patcher.
+class OTADecompressor {
+ public:
+  using Output = std::function<OTAResponseTypes(const uint8_t *data, size_t len)>;
+
+  virtual ~OTADecompressor() = default;
+
+  /// Allocate the buffers, returns false if that failed.
+  virtual bool init() = 0;
+  void set_output(Output &&output) { this->output_ = std::move(output); }
+  /// Decompress the next len bytes of the stream, passing everything that could be decompressed to the output.
+  virtual OTAResponseTypes feed(const uint8_t *data, size_t len) = 0;
+  /// Returns an error if the stream is truncated.
+  virtual OTAResponseTypes finish() = 0;
+
+ protected:
+  Output output_;
+};
+
+/** Streaming inflate of a raw deflate stream (RFC 1951) with a window of 2^window_bits bytes.
+ *
+ * Input is collected in a small buffer and only whole items (a block header or a literal/length/distance symbol) are
+ * decoded from it, so decoding can simply start over at the last item when the input runs out in the middle of one.
+ * Output goes through the window ring and is passed on in contiguous pieces.
+ */
+class OTAInflater : public OTADecompressor {
+ public:
+  explicit OTAInflater(uint8_t window_bits) : window_size_(size_t(1) << window_bits) {}
+
+  bool init() override;
+  OTAResponseTypes feed(const uint8_t *data, size_t len) override;
+  OTAResponseTypes finish() override;
+
+ protected:
+  /// Large enough for the biggest item, a dynamic block header of at most 4446 bits.
+  static const size_t INPUT_SIZE = 1024;
+  static const uint8_t MAX_BITS = 15;
+  static const uint16_t MAX_LENGTH_CODES = 288;
+  static const uint16_t MAX_DISTANCE_CODES = 30;
+
+  enum class State : uint8_t {
+    HEADER,
+    STORED,
+    CODES,
+    DONE,
+  };
+  enum class Result : uint8_t {
+    OK,
+    NEED_INPUT,
+    INVALID,
+  };
+
+  /// Canonical Huffman code, decoded a bit at a time like zlib's puff.
+  struct Huffman {
+    uint16_t count[MAX_BITS + 1];
+    uint16_t *symbol;
+  };
+
+  /// Decode as many items as the buffered input allows.
+  Result inflate_();
+  Result header_();
+  Result dynamic_header_();
+  Result codes_();
+  Result stored_();
+  void fixed_tables_();
+  /// Returns false if the code lengths are over-subscribed.
+  static bool build_(Huffman *huffman, const uint8_t *lengths, uint16_t count);
+  int decode_(const Huffman *huffman);
+
+  uint32_t bits_(uint8_t count);
+  void put_(uint8_t byte);
+  /// Pass the output that was not passed yet.
+  OTAResponseTypes emit_();
+
+  size_t window_size_;
+  std::unique_ptr<uint8_t[]> window_;
+  size_t window_pos_{0};
+  size_t emitted_pos_{0};
+  /// Output so far, distances can't reach further back than this.
+  size_t total_out_{0};
+  OTAResponseTypes output_error_{OTA_RESPONSE_OK};
+
+  std::unique_ptr<uint8_t[]> input_;
+  size_t input_len_{0};
+  size_t input_pos_{0};
+  uint32_t bit_buffer_{0};
+  uint8_t bit_count_{0};
+  bool underflow_{false};
+
+  State state_{State::HEADER};
+  bool last_block_{false};
+  uint16_t stored_remaining_{0};
+  uint16_t length_symbols_[MAX_LENGTH_CODES];
+  uint16_t distance_symbols_[MAX_DISTANCE_CODES];
+  Huffman lengths_{{}, length_symbols_};
+  Huffman distances_{{}, distance_symbols_};
+};
+
+}  // namespace ota
+}  // namespace esphome
@@ -0,0 +1,185 @@
+#include "ota_delta.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+
+#ifdef USE_ESP32
+#include <esp_image_format.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#endif
+#ifdef USE_ESP8266
+#include <Esp.h>
+#endif
+
+namespace esphome {
+namespace ota {
+
+static const char *const TAG = "ota.delta";
+
+static const uint8_t DELTA_OP_COPY = 0x01;
+static const uint8_t DELTA_OP_DATA = 0x02;
+
+#ifdef USE_ESP32
+size_t delta_base_size() {
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  if (running == nullptr)
+    return 0;
+  esp_partition_pos_t pos{};
+  pos.offset = running->address;
+  pos.size = running->size;
+  esp_image_metadata_t metadata{};
+  if (esp_image_get_metadata(&pos, &metadata) != ESP_OK)
+    return 0;
+  return metadata.image_len;
+}
+
+bool delta_base_read(size_t offset, uint8_t *data, size_t len) {
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  return running != nullptr && esp_partition_read(running, offset, data, len) == ESP_OK;
+}
+#elif defined(USE_ESP8266)
+// the running sketch always starts at the beginning of the flash, the update is staged behind it
+size_t delta_base_size() { return ESP.getSketchSize(); }
+
+bool delta_base_read(size_t offset, uint8_t *data, size_t len) { return ESP.flashRead(offset, data, len); }
+#else
+size_t delta_base_size() { return 0; }
+
+bool delta_base_read(size_t offset, uint8_t *data, size_t len) { return false; }
+#endif
+
+uint32_t delta_weak_checksum(const uint8_t *data, size_t len) {
+  uint32_t s1 = 0, s2 = 0;
+  for (size_t i = 0; i < len; i++) {
+    s1 += data[i];
+    s2 += s1;
+  }
+  return ((s2 & 0xFFFF) << 16) | (s1 & 0xFFFF);
+}
+
+OTAResponseTypes OTADeltaPatcher::feed(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    if (this->state_ == State::DATA) {
+      const size_t count = std::min<size_t>(len, this->data_remaining_);
+      OTAResponseTypes error = this->writer_->append(data, count);
+      if (error != OTA_RESPONSE_OK)
+        return error;
+      this->written_ += count;
+      data += count;
+      len -= count;
+      this->data_remaining_ -= count;
+      if (this->data_remaining_ == 0)
+        this->state_ = State::OPCODE;
+      continue;
+    }
+
+    const uint8_t byte = *data++;
+    len--;
+    if (this->state_ == State::OPCODE) {
+      if (byte == DELTA_OP_COPY) {
+        this->state_ = State::COPY_FIRST;
+      } else if (byte == DELTA_OP_DATA) {
+        this->state_ = State::DATA_LENGTH;
+      } else {
+        ESP_LOGW(TAG, "Invalid opcode 0x%02X at output offset %u", byte, this->written_);
+        return OTA_RESPONSE_ERROR_DELTA_INVALID;
+      }
+      continue;
+    }
+
+    this->varint_ |= static_cast<uint32_t>(byte & 0x7F) << this->varint_shift_;
+    if ((byte & 0x80) != 0) {
+      this->varint_shift_ += 7;
+      if (this->varint_shift_ > 28) {
+        ESP_LOGW(TAG, "Invalid argument at output offset %u", this->written_);
+        return OTA_RESPONSE_ERROR_DELTA_INVALID;
+      }
+      continue;
+    }
+    const uint32_t value = this->varint_;
+    this->varint_ = 0;
+    this->varint_shift_ = 0;
+    OTAResponseTypes error = this->on_argument_(value);
+    if (error != OTA_RESPONSE_OK)
+      return error;
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes OTADeltaPatcher::finish() {
+  if (this->state_ != State::OPCODE) {
+    ESP_LOGW(TAG, "Patch ends in the middle of an operation");
+    return OTA_RESPONSE_ERROR_DELTA_INVALID;
+  }
+  if (this->written_ != this->image_size_) {
+    ESP_LOGW(TAG, "Patch produced %u bytes, expected %u", this->written_, this->image_size_);
+    return OTA_RESPONSE_ERROR_DELTA_INVALID;
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes OTADeltaPatcher::on_argument_(uint32_t value) {
+  switch (this->state_) {
+    case State::COPY_FIRST:
+      this->copy_first_ = value;
+      this->state_ = State::COPY_COUNT;
+      return OTA_RESPONSE_OK;
+    case State::COPY_COUNT: {
+      this->state_ = State::OPCODE;
+      const uint64_t offset = static_cast<uint64_t>(this->copy_first_) * DELTA_BLOCK_SIZE;
+      const uint64_t end = offset + static_cast<uint64_t>(value) * DELTA_BLOCK_SIZE;
+      // only the last block of the running image may be partial
+      if (value == 0 || offset >= this->base_size_ || end - DELTA_BLOCK_SIZE >= this->base_size_) {
+        ESP_LOGW(TAG, "Copy of %u blocks from block %u is outside of the running image", value, this->copy_first_);
+        return OTA_RESPONSE_ERROR_DELTA_INVALID;
+      }
+      return this->copy_(offset, std::min<uint64_t>(end, this->base_size_) - offset);
+    }
+    case State::DATA_LENGTH: {
+      OTAResponseTypes error = this->check_output_(value);
+      if (error != OTA_RESPONSE_OK)
+        return error;
+      this->data_remaining_ = value;
+      this->state_ = value == 0 ? State::OPCODE : State::DATA;
+      return OTA_RESPONSE_OK;
+    }
+    default:
+      return OTA_RESPONSE_ERROR_UNKNOWN;
+  }
+}
+
+OTAResponseTypes OTADeltaPatcher::copy_(size_t offset, size_t len) {
+  OTAResponseTypes error = this->check_output_(len);
+  if (error != OTA_RESPONSE_OK)
+    return error;
+  while (len > 0) {
+    // read straight into the chunk that goes to flash
+    size_t space;
+    uint8_t *dst = this->writer_->reserve(&space);
+    const size_t count = std::min(space, len);
+    if (!delta_base_read(offset, dst, count)) {
+      ESP_LOGW(TAG, "Reading %u bytes of the running image at 0x%X failed", count, offset);
+      return OTA_RESPONSE_ERROR_UNKNOWN;
+    }
+    error = this->writer_->commit(count);
+    if (error != OTA_RESPONSE_OK)
+      return error;
+    this->written_ += count;
+    offset += count;
+    len -= count;
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes OTADeltaPatcher::check_output_(size_t len) {
+  if (len > this->image_size_ - this->written_) {
+    ESP_LOGW(TAG, "Patch produces more than %u bytes", this->image_size_);
+    return OTA_RESPONSE_ERROR_DELTA_INVALID;
+  }
+  return OTA_RESPONSE_OK;
+}
+
+}  // namespace ota
+}  // namespace esphome
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ota_component.h"
+#include "ota_writer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace ota {
+
+/// Size of the blocks of the running image that a delta update can copy from.
+static const uint32_t DELTA_BLOCK_SIZE = 2048;
+
+/// Size of the running firmware image that delta updates are based on, 0 if it can't be read on this platform.
+size_t delta_base_size();
+/// Read len bytes at offset of the running firmware image.
+bool delta_base_read(size_t offset, uint8_t *data, size_t len);
+/// Checksum of a block that can be rolled over the new image by the uploader, like rsync's.
+uint32_t delta_weak_checksum(const uint8_t *data, size_t len);
+
+/** Reconstructs the new image from a delta patch against the running image.
+ *
+ * The patch is a sequence of operations, each an opcode byte followed by varint arguments:
+ * - COPY first count: copy count blocks of DELTA_BLOCK_SIZE starting at block first of the running image.
+ * - DATA length: followed by length bytes of the new image.
+ *
+ * The patch may be fed in arbitrarily split pieces as it is received, the output goes through the writer so it
+ * streams into the update partition just like a full image would.
+ */
+class OTADeltaPatcher {
+ public:
+  OTADeltaPatcher(OTAWriter *writer, size_t base_size, size_t image_size)
+      : writer_(writer), base_size_(base_size), image_size_(image_size) {}
+
+  /// Apply the next len bytes of the patch.
+  OTAResponseTypes feed(const uint8_t *data, size_t len);
+  /// Returns an error if the patch is truncated or didn't produce exactly image_size bytes.
+  OTAResponseTypes finish();
+
+ protected:
+  enum class State : uint8_t {
+    OPCODE,
+    COPY_FIRST,
+    COPY_COUNT,
+    DATA_LENGTH,
+    DATA,
+  };
+
+  /// Handle a complete varint argument of the current operation.
+  OTAResponseTypes on_argument_(uint32_t value);
+  OTAResponseTypes copy_(size_t offset, size_t len);
+  /// Returns an error if the image would get larger than image_size bytes by adding len bytes.
+  OTAResponseTypes check_output_(size_t len);
+
+  OTAWriter *writer_;
+  size_t base_size_;
+  size_t image_size_;
+  size_t written_{0};
+
+  State state_{State::OPCODE};
+  uint32_t varint_{0};
+  uint8_t varint_shift_{0};
+  uint32_t copy_first_{0};
+  uint32_t data_remaining_{0};
+};
+
+}  // namespace ota
+}  // namespace esphome
@@ -0,0 +1,168 @@
+#include "ota_writer.h"
+#include "esphome/core/application.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace esphome {
+namespace ota {
+
+static const char *const TAG = "ota";
+
+#ifdef USE_ESP32
+/// Index of the chunk that tells the writer task to stop.
+static const uint8_t STOP_INDEX = 0xFF;
+#endif
+
+bool OTAWriter::init() {
+  for (auto &buffer : this->buffers_) {
+    buffer.reset(new (std::nothrow) uint8_t[this->buffer_size_]);  // NOLINT(cppcoreguidelines-owning-memory)
+    if (buffer == nullptr) {
+      ESP_LOGW(TAG, "Could not allocate %u bytes for the receive buffer", this->buffer_size_);
+      return false;
+    }
+  }
+
+#ifdef USE_ESP32
+  this->free_queue_ = xQueueCreate(BUFFER_COUNT + 1, sizeof(uint8_t));
+  this->filled_queue_ = xQueueCreate(BUFFER_COUNT + 1, sizeof(Chunk));
+  if (this->free_queue_ == nullptr || this->filled_queue_ == nullptr)
+    return false;
+  for (uint8_t i = 0; i < BUFFER_COUNT; i++)
+    xQueueSend(this->free_queue_, &i, 0);
+  // same priority as the loop task, it spends most of its time waiting for the flash anyway
+  if (xTaskCreate(OTAWriter::writer_task, "ota_writer", 4096, this, 1, &this->task_) != pdPASS) {
+    this->task_ = nullptr;
+    return false;
+  }
+#endif
+  return true;
+}
+
+uint8_t *OTAWriter::reserve(size_t *space) {
+  if (this->chunk_ == nullptr) {
+    this->chunk_ = this->next_buffer_();
+    this->chunk_len_ = 0;
+  }
+  *space = this->buffer_size_ - this->chunk_len_;
+  return this->chunk_ + this->chunk_len_;
+}
+
+OTAResponseTypes OTAWriter::commit(size_t len) {
+  this->chunk_len_ += len;
+  if (this->chunk_len_ < this->buffer_size_)
+    return OTA_RESPONSE_OK;
+  this->chunk_ = nullptr;
+  return this->write_(this->chunk_len_);
+}
+
+OTAResponseTypes OTAWriter::append(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    size_t space;
+    uint8_t *dst = this->reserve(&space);
+    const size_t count = std::min(space, len);
+    memcpy(dst, data, count);
+    data += count;
+    len -= count;
+    OTAResponseTypes error = this->commit(count);
+    if (error != OTA_RESPONSE_OK)
+      return error;
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes OTAWriter::flush() {
+  if (this->chunk_ != nullptr && this->chunk_len_ != 0) {
+    this->chunk_ = nullptr;
+    this->write_(this->chunk_len_);
+  }
+  return this->drain_();
+}
+
+#ifdef USE_ESP32
+OTAWriter::~OTAWriter() {
+  if (this->task_ != nullptr) {
+    this->drain_();
+    Chunk stop{STOP_INDEX, 0};
+    xQueueSend(this->filled_queue_, &stop, portMAX_DELAY);
+    // the task acknowledges the stop as its last access to this object
+    uint8_t index;
+    do {
+      xQueueReceive(this->free_queue_, &index, portMAX_DELAY);
+    } while (index != STOP_INDEX);
+  }
+  if (this->free_queue_ != nullptr)
+    vQueueDelete(this->free_queue_);
+  if (this->filled_queue_ != nullptr)
+    vQueueDelete(this->filled_queue_);
+}
+
+uint8_t *OTAWriter::next_buffer_() {
+  // both buffers can only be busy while the writer task is writing one of them, which always finishes
+  while (xQueueReceive(this->free_queue_, &this->current_, pdMS_TO_TICKS(100)) != pdTRUE)
+    App.feed_wdt();
+  return this->buffers_[this->current_].get();
+}
+
+OTAResponseTypes OTAWriter::write_(size_t len) {
+  Chunk chunk{this->current_, len};
+  xQueueSend(this->filled_queue_, &chunk, portMAX_DELAY);
+  return this->error_.load();
+}
+
+OTAResponseTypes OTAWriter::drain_() {
+  if (this->chunk_ != nullptr) {
+    // a partially received chunk that is not written, e.g. because receiving failed
+    xQueueSend(this->free_queue_, &this->current_, 0);
+    this->chunk_ = nullptr;
+  }
+  // take all buffers back from the writer task, then return them
+  uint8_t indices[BUFFER_COUNT];
+  for (auto &index : indices) {
+    while (xQueueReceive(this->free_queue_, &index, pdMS_TO_TICKS(100)) != pdTRUE)
+      App.feed_wdt();
+  }
+  for (auto &index : indices)
+    xQueueSend(this->free_queue_, &index, 0);
+  return this->error_.load();
+}
+
+void OTAWriter::writer_task(void *param) {
+  auto *writer = reinterpret_cast<OTAWriter *>(param);
+  Chunk chunk;
+  while (true) {
+    xQueueReceive(writer->filled_queue_, &chunk, portMAX_DELAY);
+    if (chunk.index == STOP_INDEX)
+      break;
+    // once a write failed, the image is broken anyway, only hand the buffers back
+    if (writer->error_.load() == OTA_RESPONSE_OK) {
+      OTAResponseTypes error = writer->backend_->write(writer->buffers_[chunk.index].get(), chunk.len);
+      if (error != OTA_RESPONSE_OK)
+        writer->error_.store(error);
+    }
+    xQueueSend(writer->free_queue_, &chunk.index, portMAX_DELAY);
+  }
+  xQueueSend(writer->free_queue_, &chunk.index, portMAX_DELAY);
+  vTaskDelete(nullptr);
+}
+#else
+OTAWriter::~OTAWriter() = default;
+
+uint8_t *OTAWriter::next_buffer_() { return this->buffers_[0].get(); }
+
+OTAResponseTypes OTAWriter::write_(size_t len) {
+  if (this->error_ == OTA_RESPONSE_OK)
+    this->error_ = this->backend_->write(this->buffers_[0].get(), len);
+  return this->error_;
+}
+
+OTAResponseTypes OTAWriter::drain_() {
+  this->chunk_ = nullptr;
+  return this->error_;
+}
+#endif
+
+}  // namespace ota
+}  // namespace esphome
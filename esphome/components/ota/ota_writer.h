@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ota_backend.h"
+#include "esphome/core/defines.h"
+
+#include <atomic>
+#include <memory>
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#endif
+
+namespace esphome {
+namespace ota {
+
+/** Hands the received image to an OTABackend in chunks of up to buffer_size bytes.
+ *
+ * On ESP32 the chunks are written from a separate task while the next one is received into a second buffer, so flash
+ * erase and write latency doesn't stall reading from the socket and the TCP window stays open. On other platforms
+ * every chunk is written synchronously from a single buffer.
+ */
+class OTAWriter {
+ public:
+  OTAWriter(OTABackend *backend, size_t buffer_size) : backend_(backend), buffer_size_(buffer_size) {}
+  /// Waits for the pending chunks and stops the writer task, so the backend can be aborted or ended afterwards.
+  ~OTAWriter();
+
+  /// Allocate the buffers and start the writer task, returns false if that failed.
+  bool init();
+
+  size_t get_buffer_size() const { return this->buffer_size_; }
+  /// Free space at the end of the chunk being filled, getting a new buffer if needed. On ESP32 this only waits if the
+  /// flash is behind by a whole buffer.
+  uint8_t *reserve(size_t *space);
+  /// Mark len bytes returned by reserve() as filled and write the chunk once it is full, returns the first error of the
+  /// backend so far.
+  OTAResponseTypes commit(size_t len);
+  /// Copy len bytes into the chunks.
+  OTAResponseTypes append(const uint8_t *data, size_t len);
+  /// Write the partially filled chunk and wait until all chunks are written, returns the first error of the backend.
+  OTAResponseTypes flush();
+
+ protected:
+  /// Get a free buffer of buffer_size_ bytes, waiting for the writer if needed.
+  uint8_t *next_buffer_();
+  /// Write the first len bytes of the buffer returned by next_buffer_().
+  OTAResponseTypes write_(size_t len);
+  /// Drop the chunk being filled and wait until all written chunks are done, returns the first error of the backend.
+  OTAResponseTypes drain_();
+
+  OTABackend *backend_;
+  size_t buffer_size_;
+#ifdef USE_ESP32
+  std::atomic<OTAResponseTypes> error_{OTA_RESPONSE_OK};
+  static const uint8_t BUFFER_COUNT = 2;
+
+  struct Chunk {
+    uint8_t index;
+    size_t len;
+  };
+
+  static void writer_task(void *param);
+
+  QueueHandle_t free_queue_{nullptr};
+  QueueHandle_t filled_queue_{nullptr};
+  TaskHandle_t task_{nullptr};
+#else
+  OTAResponseTypes error_{OTA_RESPONSE_OK};
+  static const uint8_t BUFFER_COUNT = 1;
+#endif
+  std::unique_ptr<uint8_t[]> buffers_[BUFFER_COUNT];
+  uint8_t *chunk_{nullptr};
+  size_t chunk_len_{0};
+#ifdef USE_ESP32
+  /// Index of the buffer returned by next_buffer_().
+  uint8_t current_{0};
+#endif
+};
+
+}  // namespace ota
+}  // namespace esphome
@@ -12,9 +12,8 @@ void Pipsolar::setup() {
 }
 
 void Pipsolar::empty_uart_buffer_() {
-  uint8_t byte;
-  while (this->available()) {
-    this->read_byte(&byte);
+  uint8_t buf[64];
+  while (this->read_available(buf, sizeof(buf)) > 0) {
   }
 }
 
@@ -712,26 +711,36 @@ void Pipsolar::loop() {
   }
 
   if (this->state_ == STATE_COMMAND || this->state_ == STATE_POLL) {
-    while (this->available()) {
-      uint8_t byte;
-      this->read_byte(&byte);
+    uint8_t buf[64];
+    size_t len;
+    bool done = false;
+    while (!done && (len = this->read_available(buf, sizeof(buf))) > 0) {
+      for (size_t i = 0; i < len; i++) {
+        const uint8_t byte = buf[i];
 
-      if (this->read_pos_ == PIPSOLAR_READ_BUFFER_LENGTH) {
-        this->read_pos_ = 0;
-        this->empty_uart_buffer_();
-      }
-      this->read_buffer_[this->read_pos_] = byte;
-      this->read_pos_++;
+        if (this->read_pos_ == PIPSOLAR_READ_BUFFER_LENGTH) {
+          // the rest of this chunk is dropped along with what is still buffered
+          this->read_pos_ = 0;
+          this->empty_uart_buffer_();
+          this->read_buffer_[this->read_pos_++] = byte;
+          done = true;
+          break;
+        }
+        this->read_buffer_[this->read_pos_] = byte;
+        this->read_pos_++;
 
-      // end of answer
-      if (byte == 0x0D) {
-        this->read_buffer_[this->read_pos_] = 0;
-        this->empty_uart_buffer_();
-        if (this->state_ == STATE_POLL) {
-          this->state_ = STATE_POLL_COMPLETE;
-        }
-        if (this->state_ == STATE_COMMAND) {
-          this->state_ = STATE_COMMAND_COMPLETE;
+        // end of answer
+        if (byte == 0x0D) {
+          this->read_buffer_[this->read_pos_] = 0;
+          this->empty_uart_buffer_();
+          if (this->state_ == STATE_POLL) {
+            this->state_ = STATE_POLL_COMPLETE;
+          }
+          if (this->state_ == STATE_COMMAND) {
+            this->state_ = STATE_COMMAND_COMPLETE;
+          }
+          done = true;
+          break;
         }
       }
     }  // available
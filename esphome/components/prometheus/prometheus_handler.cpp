@@ -2,351 +2,476 @@
 
 #include "prometheus_handler.h"
 #include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+#ifdef USE_ESP32
+#include <esp_heap_caps.h>
+#else
+#include <Esp.h>
+#endif
 
 namespace esphome {
 namespace prometheus {
 
-void PrometheusHandler::handleRequest(AsyncWebServerRequest *req) {
-  AsyncResponseStream *stream = req->beginResponseStream("text/plain; version=0.0.4; charset=utf-8");
+enum ScrapeSection : uint8_t {
+  SECTION_SENSOR = 0,
+  SECTION_BINARY_SENSOR,
+  SECTION_FAN,
+  SECTION_LIGHT,
+  SECTION_COVER,
+  SECTION_SWITCH,
+  SECTION_LOCK,
+  SECTION_DEVICE,
+  SECTION_DONE,
+};
 
+/// Append a label value, escaped as required by the text exposition format.
+static void append_label_value(std::string &out, const std::string &value) {
+  for (char c : value) {
+    switch (c) {
+      case '\\':
+        out += "\\\\";
+        break;
+      case '"':
+        out += "\\\"";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        out += c;
+        break;
+    }
+  }
+}
+
+static void append_float(std::string &out, float value, int8_t accuracy_decimals) {
+  if (accuracy_decimals < 0) {
+    auto multiplier = powf(10.0f, accuracy_decimals);
+    value = roundf(value * multiplier) / multiplier;
+    accuracy_decimals = 0;
+  }
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", accuracy_decimals, value);
+  out += buffer;
+}
+
+static void append_uint(std::string &out, uint32_t value) {
+  char buffer[12];
+  snprintf(buffer, sizeof(buffer), "%u", value);
+  out += buffer;
+}
+
+/// Append `<name>{<labels><extra>} `, the value is appended by the caller.
+static void append_row(std::string &out, const char *name, const std::string &labels, const char *extra = "") {
+  out += name;
+  out += '{';
+  out += labels;
+  out += extra;
+  out += "} ";
+}
+
+void PrometheusHandler::setup() {
 #ifdef USE_SENSOR
-  this->sensor_type_(stream);
-  for (auto *obj : App.get_sensors())
-    this->sensor_row_(stream, obj);
+  this->add_entities_(App.get_sensors(), this->sensors_);
+  for (auto &entity : this->sensors_) {
+    entity.value_labels = entity.labels + ",unit=\"";
+    append_label_value(entity.value_labels, entity.obj->get_unit_of_measurement());
+    entity.value_labels += '"';
+  }
 #endif
-
 #ifdef USE_BINARY_SENSOR
-  this->binary_sensor_type_(stream);
-  for (auto *obj : App.get_binary_sensors())
-    this->binary_sensor_row_(stream, obj);
+  this->add_entities_(App.get_binary_sensors(), this->binary_sensors_);
 #endif
-
 #ifdef USE_FAN
-  this->fan_type_(stream);
-  for (auto *obj : App.get_fans())
-    this->fan_row_(stream, obj);
+  this->add_entities_(App.get_fans(), this->fans_);
 #endif
-
 #ifdef USE_LIGHT
-  this->light_type_(stream);
-  for (auto *obj : App.get_lights())
-    this->light_row_(stream, obj);
+  this->add_entities_(App.get_lights(), this->lights_);
 #endif
-
 #ifdef USE_COVER
-  this->cover_type_(stream);
-  for (auto *obj : App.get_covers())
-    this->cover_row_(stream, obj);
+  this->add_entities_(App.get_covers(), this->covers_);
 #endif
-
 #ifdef USE_SWITCH
-  this->switch_type_(stream);
-  for (auto *obj : App.get_switches())
-    this->switch_row_(stream, obj);
+  this->add_entities_(App.get_switches(), this->switches_);
 #endif
-
 #ifdef USE_LOCK
-  this->lock_type_(stream);
-  for (auto *obj : App.get_locks())
-    this->lock_row_(stream, obj);
+  this->add_entities_(App.get_locks(), this->locks_);
 #endif
+  this->relabel_map_id_.clear();
+  this->relabel_map_name_.clear();
 
-  req->send(stream);
+  this->base_->init();
+  this->base_->add_handler(this);
+}
+
+void PrometheusHandler::loop() {
+  if (!this->include_device_metrics_)
+    return;
+  const uint32_t loop_time = App.get_loop_time_us();
+  uint32_t max_loop_time = this->max_loop_time_us_.load(std::memory_order_relaxed);
+#ifdef USE_ESP32
+  // retried if a scrape reset the maximum in between, so that loop isn't lost
+  while (loop_time > max_loop_time &&
+         !this->max_loop_time_us_.compare_exchange_weak(max_loop_time, loop_time, std::memory_order_relaxed)) {
+  }
+#else
+  // the web server runs between loop() calls here, and these cores have no atomic read-modify-write
+  if (loop_time > max_loop_time)
+    this->max_loop_time_us_.store(loop_time, std::memory_order_relaxed);
+#endif
+  this->scheduler_items_.store(App.scheduler.size(), std::memory_order_relaxed);
+}
+
+void PrometheusHandler::handleRequest(AsyncWebServerRequest *req) {
+  // rendered piece by piece as the connection accepts data, so the response is never held in memory as a whole
+  auto state = std::make_shared<ScrapeState>();
+  state->buffer.reserve(256);
+  AsyncWebServerResponse *response = req->beginChunkedResponse(
+      "text/plain; version=0.0.4; charset=utf-8", [this, state](uint8_t *buffer, size_t max_len, size_t index) {
+        return this->fill_chunk_(*state, buffer, max_len);
+      });
+  req->send(response);
+}
+
+size_t PrometheusHandler::fill_chunk_(ScrapeState &state, uint8_t *buffer, size_t max_len) {
+  size_t written = 0;
+  while (written < max_len) {
+    if (state.offset == state.buffer.size()) {
+      state.buffer.clear();
+      state.offset = 0;
+      if (!this->render_next_(state))
+        break;
+      continue;
+    }
+    size_t len = std::min(max_len - written, state.buffer.size() - state.offset);
+    memcpy(buffer + written, state.buffer.data() + state.offset, len);
+    state.offset += len;
+    written += len;
+  }
+  return written;
+}
+
+bool PrometheusHandler::render_next_(ScrapeState &state) {
+  std::string &out = state.buffer;
+  switch (state.section) {
+#ifdef USE_SENSOR
+    case SECTION_SENSOR:
+      if (state.index == 0)
+        this->sensor_type_(out);
+      if (state.index < this->sensors_.size()) {
+        this->sensor_row_(out, this->sensors_[state.index++]);
+        return true;
+      }
+      break;
+#endif
+#ifdef USE_BINARY_SENSOR
+    case SECTION_BINARY_SENSOR:
+      if (state.index == 0)
+        this->binary_sensor_type_(out);
+      if (state.index < this->binary_sensors_.size()) {
+        this->binary_sensor_row_(out, this->binary_sensors_[state.index++]);
+        return true;
+      }
+      break;
+#endif
+#ifdef USE_FAN
+    case SECTION_FAN:
+      if (state.index == 0)
+        this->fan_type_(out);
+      if (state.index < this->fans_.size()) {
+        this->fan_row_(out, this->fans_[state.index++]);
+        return true;
+      }
+      break;
+#endif
+#ifdef USE_LIGHT
+    case SECTION_LIGHT:
+      if (state.index == 0)
+        this->light_type_(out);
+      if (state.index < this->lights_.size()) {
+        this->light_row_(out, this->lights_[state.index++]);
+        return true;
+      }
+      break;
+#endif
+#ifdef USE_COVER
+    case SECTION_COVER:
+      if (state.index == 0)
+        this->cover_type_(out);
+      if (state.index < this->covers_.size()) {
+        this->cover_row_(out, this->covers_[state.index++]);
+        return true;
+      }
+      break;
+#endif
+#ifdef USE_SWITCH
+    case SECTION_SWITCH:
+      if (state.index == 0)
+        this->switch_type_(out);
+      if (state.index < this->switches_.size()) {
+        this->switch_row_(out, this->switches_[state.index++]);
+        return true;
+      }
+      break;
+#endif
+#ifdef USE_LOCK
+    case SECTION_LOCK:
+      if (state.index == 0)
+        this->lock_type_(out);
+      if (state.index < this->locks_.size()) {
+        this->lock_row_(out, this->locks_[state.index++]);
+        return true;
+      }
+      break;
+#endif
+    case SECTION_DEVICE:
+      if (this->include_device_metrics_)
+        this->device_rows_(out);
+      break;
+    case SECTION_DONE:
+      return false;
+    default:
+      break;
+  }
+  state.section++;
+  state.index = 0;
+  return true;
 }
 
 std::string PrometheusHandler::relabel_id_(EntityBase *obj) {
   auto item = relabel_map_id_.find(obj);
-  return item == relabel_map_id_.end() ? obj->get_object_id() : item->second;
+  return item == relabel_map_id_.end() ? obj->get_object_id().str() : item->second;
 }
 
 std::string PrometheusHandler::relabel_name_(EntityBase *obj) {
   auto item = relabel_map_name_.find(obj);
-  return item == relabel_map_name_.end() ? obj->get_name() : item->second;
+  return item == relabel_map_name_.end() ? obj->get_name().str() : item->second;
+}
+
+std::string PrometheusHandler::render_labels_(EntityBase *obj) {
+  std::string labels = "id=\"";
+  append_label_value(labels, this->relabel_id_(obj));
+  labels += "\",name=\"";
+  append_label_value(labels, this->relabel_name_(obj));
+  labels += '"';
+  return labels;
+}
+
+void PrometheusHandler::device_rows_(std::string &out) {
+  out += "#TYPE esphome_device_uptime_seconds COUNTER\n";
+  out += "esphome_device_uptime_seconds ";
+  append_uint(out, millis() / 1000);
+  out += '\n';
+
+  out += "#TYPE esphome_device_free_heap_bytes GAUGE\n";
+  out += "esphome_device_free_heap_bytes ";
+#ifdef USE_ESP32
+  append_uint(out, heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+#else
+  append_uint(out, ESP.getFreeHeap());  // NOLINT(readability-static-accessed-through-instance)
+#endif
+  out += '\n';
+
+  // reset the maximum, so each scrape covers the loop iterations since the previous one
+  out += "#TYPE esphome_device_loop_time_max_seconds GAUGE\n";
+  out += "esphome_device_loop_time_max_seconds ";
+#ifdef USE_ESP32
+  const uint32_t max_loop_time = this->max_loop_time_us_.exchange(0, std::memory_order_relaxed);
+#else
+  const uint32_t max_loop_time = this->max_loop_time_us_.load(std::memory_order_relaxed);
+  this->max_loop_time_us_.store(0, std::memory_order_relaxed);
+#endif
+  append_float(out, max_loop_time / 1e6f, 6);
+  out += '\n';
+
+  out += "#TYPE esphome_device_scheduler_items GAUGE\n";
+  out += "esphome_device_scheduler_items ";
+  append_uint(out, this->scheduler_items_.load(std::memory_order_relaxed));
+  out += '\n';
 }
 
 // Type-specific implementation
 #ifdef USE_SENSOR
-void PrometheusHandler::sensor_type_(AsyncResponseStream *stream) {
-  stream->print(F("#TYPE esphome_sensor_value GAUGE\n"));
-  stream->print(F("#TYPE esphome_sensor_failed GAUGE\n"));
+void PrometheusHandler::sensor_type_(std::string &out) {
+  out += "#TYPE esphome_sensor_value GAUGE\n";
+  out += "#TYPE esphome_sensor_failed GAUGE\n";
 }
-void PrometheusHandler::sensor_row_(AsyncResponseStream *stream, sensor::Sensor *obj) {
-  if (obj->is_internal() && !this->include_internal_)
-    return;
+void PrometheusHandler::sensor_row_(std::string &out, const MetricEntity<sensor::Sensor> &entity) {
+  sensor::Sensor *obj = entity.obj;
   if (!std::isnan(obj->state)) {
     // We have a valid value, output this value
-    stream->print(F("esphome_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} 0\n"));
+    append_row(out, "esphome_sensor_failed", entity.labels);
+    out += "0\n";
     // Data itself
-    stream->print(F("esphome_sensor_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\",unit=\""));
-    stream->print(obj->get_unit_of_measurement().c_str());
-    stream->print(F("\"} "));
-    stream->print(value_accuracy_to_string(obj->state, obj->get_accuracy_decimals()).c_str());
-    stream->print('\n');
+    append_row(out, "esphome_sensor_value", entity.value_labels);
+    append_float(out, obj->state, obj->get_accuracy_decimals());
+    out += '\n';
   } else {
     // Invalid state
-    stream->print(F("esphome_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} 1\n"));
+    append_row(out, "esphome_sensor_failed", entity.labels);
+    out += "1\n";
   }
 }
 #endif
 
 // Type-specific implementation
 #ifdef USE_BINARY_SENSOR
-void PrometheusHandler::binary_sensor_type_(AsyncResponseStream *stream) {
-  stream->print(F("#TYPE esphome_binary_sensor_value GAUGE\n"));
-  stream->print(F("#TYPE esphome_binary_sensor_failed GAUGE\n"));
+void PrometheusHandler::binary_sensor_type_(std::string &out) {
+  out += "#TYPE esphome_binary_sensor_value GAUGE\n";
+  out += "#TYPE esphome_binary_sensor_failed GAUGE\n";
 }
-void PrometheusHandler::binary_sensor_row_(AsyncResponseStream *stream, binary_sensor::BinarySensor *obj) {
-  if (obj->is_internal() && !this->include_internal_)
-    return;
+void PrometheusHandler::binary_sensor_row_(std::string &out,
+                                           const MetricEntity<binary_sensor::BinarySensor> &entity) {
+  binary_sensor::BinarySensor *obj = entity.obj;
   if (obj->has_state()) {
     // We have a valid value, output this value
-    stream->print(F("esphome_binary_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} 0\n"));
+    append_row(out, "esphome_binary_sensor_failed", entity.labels);
+    out += "0\n";
     // Data itself
-    stream->print(F("esphome_binary_sensor_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} "));
-    stream->print(obj->state);
-    stream->print('\n');
+    append_row(out, "esphome_binary_sensor_value", entity.labels);
+    out += obj->state ? "1\n" : "0\n";
   } else {
     // Invalid state
-    stream->print(F("esphome_binary_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} 1\n"));
+    append_row(out, "esphome_binary_sensor_failed", entity.labels);
+    out += "1\n";
   }
 }
 #endif
 
 #ifdef USE_FAN
-void PrometheusHandler::fan_type_(AsyncResponseStream *stream) {
-  stream->print(F("#TYPE esphome_fan_value GAUGE\n"));
-  stream->print(F("#TYPE esphome_fan_failed GAUGE\n"));
-  stream->print(F("#TYPE esphome_fan_speed GAUGE\n"));
-  stream->print(F("#TYPE esphome_fan_oscillation GAUGE\n"));
+void PrometheusHandler::fan_type_(std::string &out) {
+  out += "#TYPE esphome_fan_value GAUGE\n";
+  out += "#TYPE esphome_fan_failed GAUGE\n";
+  out += "#TYPE esphome_fan_speed GAUGE\n";
+  out += "#TYPE esphome_fan_oscillation GAUGE\n";
 }
-void PrometheusHandler::fan_row_(AsyncResponseStream *stream, fan::Fan *obj) {
-  if (obj->is_internal() && !this->include_internal_)
-    return;
-  stream->print(F("esphome_fan_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\"} 0\n"));
+void PrometheusHandler::fan_row_(std::string &out, const MetricEntity<fan::Fan> &entity) {
+  fan::Fan *obj = entity.obj;
+  append_row(out, "esphome_fan_failed", entity.labels);
+  out += "0\n";
   // Data itself
-  stream->print(F("esphome_fan_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\"} "));
-  stream->print(obj->state);
-  stream->print('\n');
+  append_row(out, "esphome_fan_value", entity.labels);
+  out += obj->state ? "1\n" : "0\n";
   // Speed if available
   if (obj->get_traits().supports_speed()) {
-    stream->print(F("esphome_fan_speed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} "));
-    stream->print(obj->speed);
-    stream->print('\n');
+    append_row(out, "esphome_fan_speed", entity.labels);
+    append_uint(out, obj->speed);
+    out += '\n';
   }
   // Oscillation if available
   if (obj->get_traits().supports_oscillation()) {
-    stream->print(F("esphome_fan_oscillation{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} "));
-    stream->print(obj->oscillating);
-    stream->print('\n');
+    append_row(out, "esphome_fan_oscillation", entity.labels);
+    out += obj->oscillating ? "1\n" : "0\n";
   }
 }
 #endif
 
 #ifdef USE_LIGHT
-void PrometheusHandler::light_type_(AsyncResponseStream *stream) {
-  stream->print(F("#TYPE esphome_light_state GAUGE\n"));
-  stream->print(F("#TYPE esphome_light_color GAUGE\n"));
-  stream->print(F("#TYPE esphome_light_effect_active GAUGE\n"));
+void PrometheusHandler::light_type_(std::string &out) {
+  out += "#TYPE esphome_light_state GAUGE\n";
+  out += "#TYPE esphome_light_color GAUGE\n";
+  out += "#TYPE esphome_light_effect_active GAUGE\n";
 }
-void PrometheusHandler::light_row_(AsyncResponseStream *stream, light::LightState *obj) {
-  if (obj->is_internal() && !this->include_internal_)
-    return;
+void PrometheusHandler::light_row_(std::string &out, const MetricEntity<light::LightState> &entity) {
+  light::LightState *obj = entity.obj;
   // State
-  stream->print(F("esphome_light_state{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\"} "));
-  stream->print(obj->remote_values.is_on());
-  stream->print(F("\n"));
+  append_row(out, "esphome_light_state", entity.labels);
+  out += obj->remote_values.is_on() ? "1\n" : "0\n";
   // Brightness and RGBW
   light::LightColorValues color = obj->current_values;
   float brightness, r, g, b, w;
   color.as_brightness(&brightness);
   color.as_rgbw(&r, &g, &b, &w);
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\",channel=\"brightness\"} "));
-  stream->print(brightness);
-  stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\",channel=\"r\"} "));
-  stream->print(r);
-  stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\",channel=\"g\"} "));
-  stream->print(g);
-  stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\",channel=\"b\"} "));
-  stream->print(b);
-  stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\",channel=\"w\"} "));
-  stream->print(w);
-  stream->print(F("\n"));
+  append_row(out, "esphome_light_color", entity.labels, ",channel=\"brightness\"");
+  append_float(out, brightness, 2);
+  out += '\n';
+  append_row(out, "esphome_light_color", entity.labels, ",channel=\"r\"");
+  append_float(out, r, 2);
+  out += '\n';
+  append_row(out, "esphome_light_color", entity.labels, ",channel=\"g\"");
+  append_float(out, g, 2);
+  out += '\n';
+  append_row(out, "esphome_light_color", entity.labels, ",channel=\"b\"");
+  append_float(out, b, 2);
+  out += '\n';
+  append_row(out, "esphome_light_color", entity.labels, ",channel=\"w\"");
+  append_float(out, w, 2);
+  out += '\n';
   // Effect
   std::string effect = obj->get_effect_name();
   if (effect == "None") {
-    stream->print(F("esphome_light_effect_active{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\",effect=\"None\"} 0\n"));
+    append_row(out, "esphome_light_effect_active", entity.labels, ",effect=\"None\"");
+    out += "0\n";
   } else {
-    stream->print(F("esphome_light_effect_active{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\",effect=\""));
-    stream->print(effect.c_str());
-    stream->print(F("\"} 1\n"));
+    out += "esphome_light_effect_active{";
+    out += entity.labels;
+    out += ",effect=\"";
+    append_label_value(out, effect);
+    out += "\"} 1\n";
   }
 }
 #endif
 
 #ifdef USE_COVER
-void PrometheusHandler::cover_type_(AsyncResponseStream *stream) {
-  stream->print(F("#TYPE esphome_cover_value GAUGE\n"));
-  stream->print(F("#TYPE esphome_cover_failed GAUGE\n"));
+void PrometheusHandler::cover_type_(std::string &out) {
+  out += "#TYPE esphome_cover_value GAUGE\n";
+  out += "#TYPE esphome_cover_failed GAUGE\n";
 }
-void PrometheusHandler::cover_row_(AsyncResponseStream *stream, cover::Cover *obj) {
-  if (obj->is_internal() && !this->include_internal_)
-    return;
+void PrometheusHandler::cover_row_(std::string &out, const MetricEntity<cover::Cover> &entity) {
+  cover::Cover *obj = entity.obj;
   if (!std::isnan(obj->position)) {
     // We have a valid value, output this value
-    stream->print(F("esphome_cover_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} 0\n"));
+    append_row(out, "esphome_cover_failed", entity.labels);
+    out += "0\n";
     // Data itself
-    stream->print(F("esphome_cover_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} "));
-    stream->print(obj->position);
-    stream->print('\n');
+    append_row(out, "esphome_cover_value", entity.labels);
+    append_float(out, obj->position, 2);
+    out += '\n';
     if (obj->get_traits().get_supports_tilt()) {
-      stream->print(F("esphome_cover_tilt{id=\""));
-      stream->print(relabel_id_(obj).c_str());
-      stream->print(F("\",name=\""));
-      stream->print(relabel_name_(obj).c_str());
-      stream->print(F("\"} "));
-      stream->print(obj->tilt);
-      stream->print('\n');
+      append_row(out, "esphome_cover_tilt", entity.labels);
+      append_float(out, obj->tilt, 2);
+      out += '\n';
     }
   } else {
     // Invalid state
-    stream->print(F("esphome_cover_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
-    stream->print(F("\"} 1\n"));
+    append_row(out, "esphome_cover_failed", entity.labels);
+    out += "1\n";
   }
 }
 #endif
 
 #ifdef USE_SWITCH
-void PrometheusHandler::switch_type_(AsyncResponseStream *stream) {
-  stream->print(F("#TYPE esphome_switch_value GAUGE\n"));
-  stream->print(F("#TYPE esphome_switch_failed GAUGE\n"));
+void PrometheusHandler::switch_type_(std::string &out) {
+  out += "#TYPE esphome_switch_value GAUGE\n";
+  out += "#TYPE esphome_switch_failed GAUGE\n";
 }
-void PrometheusHandler::switch_row_(AsyncResponseStream *stream, switch_::Switch *obj) {
-  if (obj->is_internal() && !this->include_internal_)
-    return;
-  stream->print(F("esphome_switch_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\"} 0\n"));
+void PrometheusHandler::switch_row_(std::string &out, const MetricEntity<switch_::Switch> &entity) {
+  append_row(out, "esphome_switch_failed", entity.labels);
+  out += "0\n";
   // Data itself
-  stream->print(F("esphome_switch_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\"} "));
-  stream->print(obj->state);
-  stream->print('\n');
+  append_row(out, "esphome_switch_value", entity.labels);
+  out += entity.obj->state ? "1\n" : "0\n";
 }
 #endif
 
 #ifdef USE_LOCK
-void PrometheusHandler::lock_type_(AsyncResponseStream *stream) {
-  stream->print(F("#TYPE esphome_lock_value GAUGE\n"));
-  stream->print(F("#TYPE esphome_lock_failed GAUGE\n"));
+void PrometheusHandler::lock_type_(std::string &out) {
+  out += "#TYPE esphome_lock_value GAUGE\n";
+  out += "#TYPE esphome_lock_failed GAUGE\n";
 }
-void PrometheusHandler::lock_row_(AsyncResponseStream *stream, lock::Lock *obj) {
-  if (obj->is_internal() && !this->include_internal_)
-    return;
-  stream->print(F("esphome_lock_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\"} 0\n"));
+void PrometheusHandler::lock_row_(std::string &out, const MetricEntity<lock::Lock> &entity) {
+  append_row(out, "esphome_lock_failed", entity.labels);
+  out += "0\n";
   // Data itself
-  stream->print(F("esphome_lock_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
-  stream->print(F("\"} "));
-  stream->print(obj->state);
-  stream->print('\n');
+  append_row(out, "esphome_lock_value", entity.labels);
+  append_uint(out, entity.obj->state);
+  out += '\n';
 }
 #endif
 
@@ -2,8 +2,11 @@
 
 #ifdef USE_ARDUINO
 
+#include <atomic>
 #include <map>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "esphome/components/web_server_base/web_server_base.h"
 #include "esphome/core/controller.h"
@@ -37,6 +40,13 @@ class PrometheusHandler : public AsyncWebHandler, public Component {
    */
   void add_label_name(EntityBase *obj, const std::string &value) { relabel_map_name_.insert({obj, value}); }
 
+  /** Determine whether the device's own metrics (uptime, heap, loop time, scheduler) should be exported.
+   * Defaults to false.
+   *
+   * @param include_device_metrics Whether device metrics should be exported.
+   */
+  void set_include_device_metrics(bool include_device_metrics) { include_device_metrics_ = include_device_metrics; }
+
   bool canHandle(AsyncWebServerRequest *request) override {
     if (request->method() == HTTP_GET) {
       if (request->url() == "/metrics")
@@ -48,72 +58,129 @@ class PrometheusHandler : public AsyncWebHandler, public Component {
 
   void handleRequest(AsyncWebServerRequest *req) override;
 
-  void setup() override {
-    this->base_->init();
-    this->base_->add_handler(this);
-  }
+  void setup() override;
+  void loop() override;
   float get_setup_priority() const override {
     // After WiFi
     return setup_priority::WIFI - 1.0f;
   }
 
  protected:
+  /// An exported entity with its label pairs rendered at setup.
+  template<typename T> struct MetricEntity {
+    T *obj;
+    std::string labels;        ///< `id="...",name="..."`
+    std::string value_labels;  ///< Labels of the value row, if different (sensor unit).
+  };
+
+  /// Progress of a single scrape; rows are rendered one entity at a time into buffer and copied out in chunks.
+  struct ScrapeState {
+    uint8_t section{0};
+    size_t index{0};
+    std::string buffer;
+    size_t offset{0};
+  };
+
   std::string relabel_id_(EntityBase *obj);
   std::string relabel_name_(EntityBase *obj);
+  std::string render_labels_(EntityBase *obj);
+  template<typename T> void add_entities_(const std::vector<T *> &objs, std::vector<MetricEntity<T>> &entities) {
+    for (auto *obj : objs) {
+      if (obj->is_internal() && !this->include_internal_)
+        continue;
+      entities.push_back(MetricEntity<T>{obj, this->render_labels_(obj), {}});
+    }
+  }
+
+  /// Fill the next chunk of the response, returns 0 once everything was sent.
+  size_t fill_chunk_(ScrapeState &state, uint8_t *buffer, size_t max_len);
+  /// Render the next entity (or section header) into state.buffer, returns false at the end of the response.
+  bool render_next_(ScrapeState &state);
+
+  void device_rows_(std::string &out);
 
 #ifdef USE_SENSOR
   /// Return the type for prometheus
-  void sensor_type_(AsyncResponseStream *stream);
+  void sensor_type_(std::string &out);
   /// Return the sensor state as prometheus data point
-  void sensor_row_(AsyncResponseStream *stream, sensor::Sensor *obj);
+  void sensor_row_(std::string &out, const MetricEntity<sensor::Sensor> &entity);
 #endif
 
 #ifdef USE_BINARY_SENSOR
   /// Return the type for prometheus
-  void binary_sensor_type_(AsyncResponseStream *stream);
+  void binary_sensor_type_(std::string &out);
   /// Return the sensor state as prometheus data point
-  void binary_sensor_row_(AsyncResponseStream *stream, binary_sensor::BinarySensor *obj);
+  void binary_sensor_row_(std::string &out, const MetricEntity<binary_sensor::BinarySensor> &entity);
 #endif
 
 #ifdef USE_FAN
   /// Return the type for prometheus
-  void fan_type_(AsyncResponseStream *stream);
+  void fan_type_(std::string &out);
   /// Return the sensor state as prometheus data point
-  void fan_row_(AsyncResponseStream *stream, fan::Fan *obj);
+  void fan_row_(std::string &out, const MetricEntity<fan::Fan> &entity);
 #endif
 
 #ifdef USE_LIGHT
   /// Return the type for prometheus
-  void light_type_(AsyncResponseStream *stream);
+  void light_type_(std::string &out);
   /// Return the Light Values state as prometheus data point
-  void light_row_(AsyncResponseStream *stream, light::LightState *obj);
+  void light_row_(std::string &out, const MetricEntity<light::LightState> &entity);
 #endif
 
 #ifdef USE_COVER
   /// Return the type for prometheus
-  void cover_type_(AsyncResponseStream *stream);
+  void cover_type_(std::string &out);
   /// Return the switch Values state as prometheus data point
-  void cover_row_(AsyncResponseStream *stream, cover::Cover *obj);
+  void cover_row_(std::string &out, const MetricEntity<cover::Cover> &entity);
 #endif
 
 #ifdef USE_SWITCH
   /// Return the type for prometheus
-  void switch_type_(AsyncResponseStream *stream);
+  void switch_type_(std::string &out);
   /// Return the switch Values state as prometheus data point
-  void switch_row_(AsyncResponseStream *stream, switch_::Switch *obj);
+  void switch_row_(std::string &out, const MetricEntity<switch_::Switch> &entity);
 #endif
 
 #ifdef USE_LOCK
   /// Return the type for prometheus
-  void lock_type_(AsyncResponseStream *stream);
+  void lock_type_(std::string &out);
   /// Return the lock Values state as prometheus data point
-  void lock_row_(AsyncResponseStream *stream, lock::Lock *obj);
+  void lock_row_(std::string &out, const MetricEntity<lock::Lock> &entity);
 #endif
 
   web_server_base::WebServerBase *base_;
   bool include_internal_{false};
+  bool include_device_metrics_{false};
+  /// Only used until the labels are rendered in setup().
   std::map<EntityBase *, std::string> relabel_map_id_;
   std::map<EntityBase *, std::string> relabel_map_name_;
+  // written by loop() and read by the scrape, which runs in the web server task on ESP32
+  /// Longest loop() duration seen since the last scrape, in microseconds.
+  std::atomic<uint32_t> max_loop_time_us_{0};
+  /// Number of scheduler items as of the last loop(), the scheduler itself may only be read from the main loop.
+  std::atomic<uint32_t> scheduler_items_{0};
+
+#ifdef USE_SENSOR
+  std::vector<MetricEntity<sensor::Sensor>> sensors_;
+#endif
+#ifdef USE_BINARY_SENSOR
+  std::vector<MetricEntity<binary_sensor::BinarySensor>> binary_sensors_;
+#endif
+#ifdef USE_FAN
+  std::vector<MetricEntity<fan::Fan>> fans_;
+#endif
+#ifdef USE_LIGHT
+  std::vector<MetricEntity<light::LightState>> lights_;
+#endif
+#ifdef USE_COVER
+  std::vector<MetricEntity<cover::Cover>> covers_;
+#endif
+#ifdef USE_SWITCH
+  std::vector<MetricEntity<switch_::Switch>> switches_;
+#endif
+#ifdef USE_LOCK
+  std::vector<MetricEntity<lock::Lock>> locks_;
+#endif
 };
 
 }  // namespace prometheus
@@ -1,6 +1,8 @@
 #include "radon_eye_listener.h"
 #include "esphome/core/log.h"
 
+#include <cstring>
+
 #ifdef USE_ESP32
 
 namespace esphome {
@@ -9,11 +11,15 @@ namespace radon_eye_ble {
 static const char *const TAG = "radon_eye_ble";
 
 bool RadonEyeListener::parse_device(const esp32_ble_tracker::ESPBTDevice &device) {
-  if (not device.get_name().empty()) {
-    if (device.get_name().rfind("FR:R20:SN", 0) == 0) {
+  static const char PREFIX[] = "FR:R20:SN";
+  for (const auto &record : device.get_adv_data()) {
+    if (record.type != ESP_BLE_AD_TYPE_NAME_CMPL && record.type != ESP_BLE_AD_TYPE_NAME_SHORT)
+      continue;
+    if (record.length >= sizeof(PREFIX) - 1 && memcmp(record.data, PREFIX, sizeof(PREFIX) - 1) == 0) {
       // This is an RD200, I think
       ESP_LOGD(TAG, "Found Radon Eye RD200 device Name: %s (MAC: %s)", device.get_name().c_str(),
                device.address_str().c_str());
+      break;
     }
   }
   return false;
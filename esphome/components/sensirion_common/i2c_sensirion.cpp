@@ -18,7 +18,9 @@ bool SensirionI2CDevice::read_data(uint16_t *data, uint8_t len) {
   if (last_error_ != i2c::ERROR_OK) {
     return false;
   }
-
+  return this->decode_data_(buf.data(), data, len);
+}
+bool SensirionI2CDevice::decode_data_(const uint8_t *buf, uint16_t *data, uint8_t len) {
   for (uint8_t i = 0; i < len; i++) {
     const uint8_t j = 3 * i;
     uint8_t crc = sht_crc_(buf[j], buf[j + 1]);
@@ -132,6 +132,14 @@ class SensirionI2CDevice : public i2c::I2CDevice {
    */
   bool get_register_(uint16_t reg, CommandLen command_len, uint16_t *data, uint8_t len, uint8_t delay);
 
+  /** Check the crc of data words that were read from the device, e.g. with read_async().
+   * @param buf raw bytes as read from the device, 3 per word
+   * @param data pointer to the decoded words
+   * @param len number of words
+   * @return true if all crcs matched
+   */
+  bool decode_data_(const uint8_t *buf, uint16_t *data, uint8_t len);
+
   /** 8-bit CRC checksum that is transmitted after each data word for read and write operation
    * @param command i2c command to send
    * @param data data word for which the crc8 checksum is calculated
@@ -6,6 +6,21 @@ namespace sensor {
 
 static const char *const TAG = "sensor";
 
+// Point an override at a new string, copying it if it's not known to outlive the sensor. Sensors are never destroyed,
+// so a copy only needs to be released when it's replaced.
+static void set_override(const char *&target, bool &owned, const char *value, bool copy) {
+  const char *previous = owned ? target : nullptr;
+  if (copy) {
+    const size_t len = strlen(value);
+    char *buffer = new char[len + 1];  // NOLINT(cppcoreguidelines-owning-memory)
+    memcpy(buffer, value, len + 1);
+    value = buffer;
+  }
+  target = value;
+  owned = copy;
+  delete[] previous;  // NOLINT(cppcoreguidelines-owning-memory)
+}
+
 std::string state_class_to_string(StateClass state_class) {
   switch (state_class) {
     case STATE_CLASS_MEASUREMENT:
@@ -24,15 +39,18 @@ Sensor::Sensor(const std::string &name) : EntityBase(name), state(NAN), raw_stat
 Sensor::Sensor() : Sensor("") {}
 
 std::string Sensor::get_unit_of_measurement() {
-  if (this->unit_of_measurement_.has_value())
-    return *this->unit_of_measurement_;
+  if (this->unit_of_measurement_ != nullptr)
+    return this->unit_of_measurement_;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
   return this->unit_of_measurement();
 #pragma GCC diagnostic pop
 }
+void Sensor::set_unit_of_measurement(const char *unit_of_measurement) {
+  set_override(this->unit_of_measurement_, this->has_own_unit_of_measurement_, unit_of_measurement, false);
+}
 void Sensor::set_unit_of_measurement(const std::string &unit_of_measurement) {
-  this->unit_of_measurement_ = unit_of_measurement;
+  set_override(this->unit_of_measurement_, this->has_own_unit_of_measurement_, unit_of_measurement.c_str(), true);
 }
 std::string Sensor::unit_of_measurement() { return ""; }
 
@@ -48,14 +66,19 @@ void Sensor::set_accuracy_decimals(int8_t accuracy_decimals) { this->accuracy_de
 int8_t Sensor::accuracy_decimals() { return 0; }
 
 std::string Sensor::get_device_class() {
-  if (this->device_class_.has_value())
-    return *this->device_class_;
+  if (this->device_class_ != nullptr)
+    return this->device_class_;
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
   return this->device_class();
 #pragma GCC diagnostic pop
 }
-void Sensor::set_device_class(const std::string &device_class) { this->device_class_ = device_class; }
+void Sensor::set_device_class(const char *device_class) {
+  set_override(this->device_class_, this->has_own_device_class_, device_class, false);
+}
+void Sensor::set_device_class(const std::string &device_class) {
+  set_override(this->device_class_, this->has_own_device_class_, device_class.c_str(), true);
+}
 std::string Sensor::device_class() { return ""; }
 
 void Sensor::set_state_class(StateClass state_class) { this->state_class_ = state_class; }
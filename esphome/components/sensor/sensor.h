@@ -61,7 +61,9 @@ class Sensor : public EntityBase {
 
   /// Get the unit of measurement, using the manual override if set.
   std::string get_unit_of_measurement();
-  /// Manually set the unit of measurement.
+  /// Manually set the unit of measurement. Only the pointer is stored, the string must outlive the sensor (like the
+  /// string literals emitted by the code generator), the std::string overload copies it.
+  void set_unit_of_measurement(const char *unit_of_measurement);
   void set_unit_of_measurement(const std::string &unit_of_measurement);
 
   /// Get the accuracy in decimals, using the manual override if set.
@@ -71,7 +73,9 @@ class Sensor : public EntityBase {
 
   /// Get the device class, using the manual override if set.
   std::string get_device_class();
-  /// Manually set the device class.
+  /// Manually set the device class. Only the pointer is stored, the string must outlive the sensor (like the string
+  /// literals emitted by the code generator), the std::string overload copies it.
+  void set_device_class(const char *device_class);
   void set_device_class(const std::string &device_class);
 
   /// Get the state class, using the manual override if set.
@@ -190,11 +194,14 @@ class Sensor : public EntityBase {
   bool has_state_{false};
   Filter *filter_list_{nullptr};  ///< Store all active filters.
 
-  optional<std::string> unit_of_measurement_;           ///< Unit of measurement override
+  const char *unit_of_measurement_{nullptr};            ///< Unit of measurement override
   optional<int8_t> accuracy_decimals_;                  ///< Accuracy in decimals override
-  optional<std::string> device_class_;                  ///< Device class override
+  const char *device_class_{nullptr};                   ///< Device class override
   optional<StateClass> state_class_{STATE_CLASS_NONE};  ///< State class override
   bool force_update_{false};                            ///< Force update mode
+  /// Whether unit_of_measurement_ and device_class_ point to heap copies owned by this sensor.
+  bool has_own_unit_of_measurement_{false};
+  bool has_own_device_class_{false};
 };
 
 }  // namespace sensor
@@ -47,22 +47,25 @@ void SHT3XDComponent::update() {
     return;
   }
 
+  // the read is queued on buses that support it, so the main loop doesn't wait for the transfer
   this->set_timeout(50, [this]() {
-    uint16_t raw_data[2];
-    if (!this->read_data(raw_data, 2)) {
-      this->status_set_warning();
-      return;
-    }
+    this->read_async(this->raw_data_, sizeof(this->raw_data_), [this](i2c::ErrorCode err) {
+      uint16_t raw_data[2];
+      if (err != i2c::ERROR_OK || !this->decode_data_(this->raw_data_, raw_data, 2)) {
+        this->status_set_warning();
+        return;
+      }
 
-    float temperature = 175.0f * float(raw_data[0]) / 65535.0f - 45.0f;
-    float humidity = 100.0f * float(raw_data[1]) / 65535.0f;
+      float temperature = 175.0f * float(raw_data[0]) / 65535.0f - 45.0f;
+      float humidity = 100.0f * float(raw_data[1]) / 65535.0f;
 
-    ESP_LOGD(TAG, "Got temperature=%.2f°C humidity=%.2f%%", temperature, humidity);
-    if (this->temperature_sensor_ != nullptr)
-      this->temperature_sensor_->publish_state(temperature);
-    if (this->humidity_sensor_ != nullptr)
-      this->humidity_sensor_->publish_state(humidity);
-    this->status_clear_warning();
+      ESP_LOGD(TAG, "Got temperature=%.2f°C humidity=%.2f%%", temperature, humidity);
+      if (this->temperature_sensor_ != nullptr)
+        this->temperature_sensor_->publish_state(temperature);
+      if (this->humidity_sensor_ != nullptr)
+        this->humidity_sensor_->publish_state(humidity);
+      this->status_clear_warning();
+    });
   });
 }
 
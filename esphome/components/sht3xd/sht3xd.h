@@ -21,6 +21,8 @@ class SHT3XDComponent : public PollingComponent, public sensirion_common::Sensir
  protected:
   sensor::Sensor *temperature_sensor_{nullptr};
   sensor::Sensor *humidity_sensor_{nullptr};
+  /// Raw measurement with crcs, filled by the queued read.
+  uint8_t raw_data_[6];
 };
 
 }  // namespace sht3xd
@@ -24,32 +24,36 @@ char Sml::check_start_end_bytes_(uint8_t byte) {
 }
 
 void Sml::loop() {
-  while (available()) {
-    const char c = read();
-
-    if (this->record_)
-      this->sml_data_.emplace_back(c);
-
-    switch (this->check_start_end_bytes_(c)) {
-      case START_BYTES_DETECTED: {
-        this->record_ = true;
-        this->sml_data_.clear();
-        break;
-      };
-      case END_BYTES_DETECTED: {
-        if (this->record_) {
-          this->record_ = false;
-
-          if (!check_sml_data(this->sml_data_))
-            break;
-
-          // remove footer bytes
-          this->sml_data_.resize(this->sml_data_.size() - 8);
-          this->process_sml_file_(this->sml_data_);
-        }
-        break;
+  uint8_t buf[64];
+  size_t len;
+  while ((len = this->read_available(buf, sizeof(buf))) > 0) {
+    for (size_t i = 0; i < len; i++) {
+      const char c = buf[i];
+
+      if (this->record_)
+        this->sml_data_.emplace_back(c);
+
+      switch (this->check_start_end_bytes_(c)) {
+        case START_BYTES_DETECTED: {
+          this->record_ = true;
+          this->sml_data_.clear();
+          break;
+        };
+        case END_BYTES_DETECTED: {
+          if (this->record_) {
+            this->record_ = false;
+
+            if (!check_sml_data(this->sml_data_))
+              break;
+
+            // remove footer bytes
+            this->sml_data_.resize(this->sml_data_.size() - 8);
+            this->process_sml_file_(this->sml_data_);
+          }
+          break;
+        };
       };
-    };
+    }
   }
 }
 
@@ -331,26 +331,7 @@ class LWIPRawImpl : public Socket {
         break;
       size_t copysize = std::min(len, pb_left);
       memcpy(buf8, reinterpret_cast<uint8_t *>(rx_buf_->payload) + rx_buf_offset_, copysize);
-
-      if (pb_left == copysize) {
-        // full pb copied, free it
-        if (rx_buf_->next == nullptr) {
-          // last buffer in chain
-          pbuf_free(rx_buf_);
-          rx_buf_ = nullptr;
-          rx_buf_offset_ = 0;
-        } else {
-          auto *old_buf = rx_buf_;
-          rx_buf_ = rx_buf_->next;
-          pbuf_ref(rx_buf_);
-          pbuf_free(old_buf);
-          rx_buf_offset_ = 0;
-        }
-      } else {
-        rx_buf_offset_ += copysize;
-      }
-      LWIP_LOG("tcp_recved(%p %u)", pcb_, copysize);
-      tcp_recved(pcb_, copysize);
+      this->consume_segment_(copysize);
 
       buf8 += copysize;
       len -= copysize;
@@ -364,6 +345,51 @@ class LWIPRawImpl : public Socket {
 
     return read;
   }
+  int peek(struct iovec *iov, int iovcnt) override {
+    if (pcb_ == nullptr) {
+      errno = ECONNRESET;
+      return -1;
+    }
+    if (rx_closed_ && rx_buf_ == nullptr) {
+      return 0;
+    }
+
+    int count = 0;
+    size_t offset = rx_buf_offset_;
+    for (struct pbuf *pb = rx_buf_; pb != nullptr && count < iovcnt; pb = pb->next) {
+      if (pb->len == offset)
+        break;
+      iov[count].iov_base = reinterpret_cast<uint8_t *>(pb->payload) + offset;
+      iov[count].iov_len = pb->len - offset;
+      count++;
+      offset = 0;
+    }
+
+    if (count == 0) {
+      errno = EWOULDBLOCK;
+      return -1;
+    }
+    return count;
+  }
+  int consume(size_t len) override {
+    if (pcb_ == nullptr) {
+      errno = ECONNRESET;
+      return -1;
+    }
+    while (len && rx_buf_ != nullptr) {
+      size_t pb_left = rx_buf_->len - rx_buf_offset_;
+      if (pb_left == 0)
+        break;
+      size_t size = std::min(len, pb_left);
+      this->consume_segment_(size);
+      len -= size;
+    }
+    if (len != 0) {
+      errno = EINVAL;
+      return -1;
+    }
+    return 0;
+  }
   ssize_t readv(const struct iovec *iov, int iovcnt) override {
     ssize_t ret = 0;
     for (int i = 0; i < iovcnt; i++) {
@@ -541,6 +567,29 @@ class LWIPRawImpl : public Socket {
   }
 
  protected:
+  /// Drop len bytes from the first pbuf of rx_buf_, freeing it once it's fully read, and open the receive window.
+  void consume_segment_(size_t len) {
+    if (rx_buf_->len - rx_buf_offset_ == len) {
+      // full pb consumed, free it
+      if (rx_buf_->next == nullptr) {
+        // last buffer in chain
+        pbuf_free(rx_buf_);
+        rx_buf_ = nullptr;
+        rx_buf_offset_ = 0;
+      } else {
+        auto *old_buf = rx_buf_;
+        rx_buf_ = rx_buf_->next;
+        pbuf_ref(rx_buf_);
+        pbuf_free(old_buf);
+        rx_buf_offset_ = 0;
+      }
+    } else {
+      rx_buf_offset_ += len;
+    }
+    LWIP_LOG("tcp_recved(%p %u)", pcb_, len);
+    tcp_recved(pcb_, len);
+  }
+
   int ip2sockaddr_(ip_addr_t *ip, uint16_t port, struct sockaddr *name, socklen_t *addrlen) {
     if (family_ == AF_INET) {
       if (*addrlen < sizeof(struct sockaddr_in)) {
@@ -1,4 +1,5 @@
 #pragma once
+#include <cerrno>
 #include <string>
 #include <memory>
 
@@ -32,6 +33,21 @@ class Socket {
   virtual int listen(int backlog) = 0;
   virtual ssize_t read(void *buf, size_t len) = 0;
   virtual ssize_t readv(const struct iovec *iov, int iovcnt) = 0;
+  /** Expose up to iovcnt segments of the received data in iov without copying or consuming it.
+   *
+   * Returns the number of segments filled in, 0 at the end of the stream or -1 with errno set: EWOULDBLOCK if no data
+   * was received yet, EOPNOTSUPP if the implementation has no receive buffers of its own. The segments stay valid and
+   * may be modified in place until the data is consumed with consume() or read().
+   */
+  virtual int peek(struct iovec *iov, int iovcnt) {
+    errno = EOPNOTSUPP;
+    return -1;
+  }
+  /// Discard the first len bytes of the data returned by peek().
+  virtual int consume(size_t len) {
+    errno = EOPNOTSUPP;
+    return -1;
+  }
   virtual ssize_t write(const void *buf, size_t len) = 0;
   virtual ssize_t writev(const struct iovec *iov, int iovcnt) = 0;
   virtual int setblocking(bool blocking) = 0;
@@ -3,17 +3,35 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/application.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace esphome {
 namespace spi {
 
 static const char *const TAG = "spi";
 
-void IRAM_ATTR HOT SPIComponent::disable() {
+#ifdef USE_SPI_IDF_BACKEND
+/// Transfers up to this length are polled, the interrupt and task switch of a queued transfer cost more.
+static const size_t SPI_POLLING_MAX_LENGTH = 32;
+/// Longer transfers are split into chunks of this size, the most the driver does in one DMA transaction.
+static const size_t SPI_MAX_CHUNK_SIZE = 4092;
+/// Chunks that are queued at once, so the bus doesn't idle between them.
+static const uint8_t SPI_QUEUE_SIZE = 4;
+#endif  // USE_SPI_IDF_BACKEND
+
+void HOT SPIComponent::disable() {
 #ifdef USE_SPI_ARDUINO_BACKEND
   if (this->hw_spi_ != nullptr) {
     this->hw_spi_->endTransaction();
   }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+  if (this->hw_device_ != nullptr) {
+    spi_device_release_bus(this->hw_device_);
+    this->hw_device_ = nullptr;
+  }
+#endif  // USE_SPI_IDF_BACKEND
   if (this->active_cs_) {
     this->active_cs_->digital_write(true);
     this->active_cs_ = nullptr;
@@ -24,7 +42,7 @@ void SPIComponent::setup() {
   this->clk_->setup();
   this->clk_->digital_write(true);
 
-#ifdef USE_SPI_ARDUINO_BACKEND
+#if defined(USE_SPI_ARDUINO_BACKEND) || defined(USE_SPI_IDF_BACKEND)
   bool use_hw_spi = true;
   const bool has_miso = this->miso_ != nullptr;
   const bool has_mosi = this->mosi_ != nullptr;
@@ -66,7 +84,7 @@ void SPIComponent::setup() {
     return;
   }
 #endif  // USE_ESP8266
-#ifdef USE_ESP32
+#if defined(USE_ESP32) && defined(USE_SPI_ARDUINO_BACKEND)
   static uint8_t spi_bus_num = 0;
   if (spi_bus_num >= 2) {
     use_hw_spi = false;
@@ -86,8 +104,12 @@ void SPIComponent::setup() {
     this->hw_spi_->begin(clk_pin, miso_pin, mosi_pin);
     return;
   }
-#endif  // USE_ESP32
-#endif  // USE_SPI_ARDUINO_BACKEND
+#endif  // USE_ESP32 && USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+  if (use_hw_spi && this->hw_setup_(clk_pin, miso_pin, mosi_pin))
+    return;
+#endif  // USE_SPI_IDF_BACKEND
+#endif  // USE_SPI_ARDUINO_BACKEND || USE_SPI_IDF_BACKEND
 
   if (this->miso_ != nullptr) {
     this->miso_->setup();
@@ -105,9 +127,152 @@ void SPIComponent::dump_config() {
 #ifdef USE_SPI_ARDUINO_BACKEND
   ESP_LOGCONFIG(TAG, "  Using HW SPI: %s", YESNO(this->hw_spi_ != nullptr));
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+  ESP_LOGCONFIG(TAG, "  Using HW SPI: %s", YESNO(this->hw_host_ready_));
+#endif  // USE_SPI_IDF_BACKEND
 }
 float SPIComponent::get_setup_priority() const { return setup_priority::BUS; }
 
+#ifdef USE_SPI_IDF_BACKEND
+bool SPIComponent::hw_setup_(int clk, int miso, int mosi) {
+  static const spi_host_device_t HOSTS[] = {
+    SPI2_HOST,
+#if SOC_SPI_PERIPH_NUM > 2
+    SPI3_HOST,
+#endif
+  };
+  static uint8_t spi_bus_num = 0;
+  if (spi_bus_num >= sizeof(HOSTS) / sizeof(HOSTS[0]))
+    return false;
+
+  spi_bus_config_t config{};
+  config.sclk_io_num = clk;
+  config.miso_io_num = miso;
+  config.mosi_io_num = mosi;
+  config.quadwp_io_num = -1;
+  config.quadhd_io_num = -1;
+  config.max_transfer_sz = SPI_MAX_CHUNK_SIZE;
+  esp_err_t err = spi_bus_initialize(HOSTS[spi_bus_num], &config, SPI_DMA_CH_AUTO);
+  if (err != ESP_OK) {
+    ESP_LOGW(TAG, "Initializing the SPI host failed: %s, falling back to software SPI", esp_err_to_name(err));
+    return false;
+  }
+  this->hw_host_ = HOSTS[spi_bus_num++];
+  this->hw_host_ready_ = true;
+  return true;
+}
+
+void SPIComponent::hw_enable_(uint8_t mode, bool lsb_first, uint32_t data_rate) {
+  // the pins are routed to the SPI peripheral, so there is no falling back to software SPI
+  if (this->is_failed())
+    return;
+  spi_device_handle_t handle = nullptr;
+  for (auto &device : this->hw_devices_) {
+    if (device.mode == mode && device.lsb_first == lsb_first && device.data_rate == data_rate) {
+      handle = device.handle;
+      break;
+    }
+  }
+  if (handle == nullptr) {
+    spi_device_interface_config_t config{};
+    config.mode = mode;
+    config.clock_speed_hz = data_rate;
+    // chip select is driven by enable() and disable() like with the other backends
+    config.spics_io_num = -1;
+    config.queue_size = SPI_QUEUE_SIZE;
+    config.flags = lsb_first ? SPI_DEVICE_BIT_LSBFIRST : 0;
+    esp_err_t err = spi_bus_add_device(this->hw_host_, &config, &handle);
+    if (err != ESP_OK) {
+      ESP_LOGE(TAG, "Adding SPI device with mode %u at %u Hz failed: %s", mode, data_rate, esp_err_to_name(err));
+      this->mark_failed();
+      return;
+    }
+    this->hw_devices_.push_back(HWDevice{mode, lsb_first, data_rate, handle});
+  }
+  // keep the bus for the whole transaction, which saves locking it for every transfer
+  esp_err_t err = spi_device_acquire_bus(handle, portMAX_DELAY);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Acquiring the SPI bus failed: %s", esp_err_to_name(err));
+    this->mark_failed();
+    return;
+  }
+  this->hw_device_ = handle;
+}
+
+void HOT SPIComponent::hw_transfer_(const uint8_t *tx, uint8_t *rx, size_t length) {
+  // the bit-bang pins are not set up with a hardware host, so a failed enable() leaves nothing to transfer with
+  if (length == 0 || this->hw_device_ == nullptr)
+    return;
+
+  if (length <= SPI_POLLING_MAX_LENGTH) {
+    spi_transaction_t trans{};
+    trans.length = length * 8;
+    if (length <= 4) {
+      // small enough for the transaction itself, which saves the driver a DMA bounce buffer
+      trans.flags = SPI_TRANS_USE_TXDATA | (rx != nullptr ? SPI_TRANS_USE_RXDATA : 0);
+      if (tx != nullptr)
+        memcpy(trans.tx_data, tx, length);
+    } else {
+      trans.tx_buffer = tx;
+      trans.rx_buffer = rx;
+    }
+    esp_err_t err = spi_device_polling_transmit(this->hw_device_, &trans);
+    if (err != ESP_OK) {
+      ESP_LOGW(TAG, "SPI transfer failed: %s", esp_err_to_name(err));
+      return;
+    }
+    if (rx != nullptr && length <= 4)
+      memcpy(rx, trans.rx_data, length);
+    return;
+  }
+
+  spi_transaction_t trans[SPI_QUEUE_SIZE];
+  size_t offset = 0;
+  uint32_t queued = 0, done = 0;
+  while (offset < length || done < queued) {
+    if (offset < length && queued - done < SPI_QUEUE_SIZE) {
+      const size_t chunk = std::min(length - offset, SPI_MAX_CHUNK_SIZE);
+      spi_transaction_t &next = trans[queued % SPI_QUEUE_SIZE];
+      memset(&next, 0, sizeof(next));
+      next.length = chunk * 8;
+      next.tx_buffer = tx != nullptr ? tx + offset : nullptr;
+      next.rx_buffer = rx != nullptr ? rx + offset : nullptr;
+      esp_err_t err = spi_device_queue_trans(this->hw_device_, &next, portMAX_DELAY);
+      if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Queueing SPI transfer failed: %s", esp_err_to_name(err));
+        // still collect what was queued, the buffers must stay valid until then
+        offset = length;
+        continue;
+      }
+      queued++;
+      offset += chunk;
+      continue;
+    }
+    spi_transaction_t *result;
+    esp_err_t err = spi_device_get_trans_result(this->hw_device_, &result, portMAX_DELAY);
+    if (err != ESP_OK) {
+      ESP_LOGW(TAG, "Waiting for SPI transfer failed: %s", esp_err_to_name(err));
+      return;
+    }
+    done++;
+  }
+}
+
+void SPIComponent::hw_write_array16_(const uint16_t *data, size_t length) {
+  uint8_t buffer[256];
+  while (length > 0) {
+    const size_t count = std::min(length, sizeof(buffer) / 2);
+    for (size_t i = 0; i < count; i++) {
+      buffer[i * 2] = data[i] >> 8;
+      buffer[i * 2 + 1] = data[i];
+    }
+    this->hw_transfer_(buffer, nullptr, count * 2);
+    data += count;
+    length -= count;
+  }
+}
+#endif  // USE_SPI_IDF_BACKEND
+
 void SPIComponent::cycle_clock_(bool value) {
   uint32_t start = arch_get_cpu_cycle_count();
   while (start - arch_get_cpu_cycle_count() < this->wait_cycle_)
@@ -8,9 +8,16 @@
 #define USE_SPI_ARDUINO_BACKEND
 #endif
 
+#ifdef USE_ESP_IDF
+#define USE_SPI_IDF_BACKEND
+#endif
+
 #ifdef USE_SPI_ARDUINO_BACKEND
 #include <SPI.h>
 #endif
+#ifdef USE_SPI_IDF_BACKEND
+#include <driver/spi_master.h>
+#endif
 
 namespace esphome {
 namespace spi {
@@ -85,6 +92,13 @@ class SPIComponent : public Component {
       return this->hw_spi_->transfer(0x00);
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+    if (this->hw_host_ready_) {
+      uint8_t data = 0x00;
+      this->hw_transfer_(&data, &data, 1);
+      return data;
+    }
+#endif  // USE_SPI_IDF_BACKEND
     return this->transfer_<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE, true, false>(0x00);
   }
 
@@ -96,6 +110,13 @@ class SPIComponent : public Component {
       return;
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+    if (this->hw_host_ready_) {
+      // the driver sends zeros without a transmit buffer
+      this->hw_transfer_(nullptr, data, length);
+      return;
+    }
+#endif  // USE_SPI_IDF_BACKEND
     for (size_t i = 0; i < length; i++) {
       data[i] = this->read_byte<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE>();
     }
@@ -113,6 +134,12 @@ class SPIComponent : public Component {
       return;
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+    if (this->hw_host_ready_) {
+      this->hw_transfer_(&data, nullptr, 1);
+      return;
+    }
+#endif  // USE_SPI_IDF_BACKEND
     this->transfer_<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE, false, true>(data);
   }
 
@@ -128,6 +155,13 @@ class SPIComponent : public Component {
       return;
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+    if (this->hw_host_ready_) {
+      const uint8_t bytes[2] = {static_cast<uint8_t>(data >> 8), static_cast<uint8_t>(data)};
+      this->hw_transfer_(bytes, nullptr, 2);
+      return;
+    }
+#endif  // USE_SPI_IDF_BACKEND
 
     this->write_byte<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE>(data >> 8);
     this->write_byte<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE>(data);
@@ -147,6 +181,12 @@ class SPIComponent : public Component {
       return;
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+    if (this->hw_host_ready_) {
+      this->hw_write_array16_(data, length);
+      return;
+    }
+#endif  // USE_SPI_IDF_BACKEND
     for (size_t i = 0; i < length; i++) {
       this->write_byte16<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE>(data[i]);
     }
@@ -165,6 +205,12 @@ class SPIComponent : public Component {
       return;
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+    if (this->hw_host_ready_) {
+      this->hw_transfer_(data, nullptr, length);
+      return;
+    }
+#endif  // USE_SPI_IDF_BACKEND
     for (size_t i = 0; i < length; i++) {
       this->write_byte<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE>(data[i]);
     }
@@ -178,6 +224,12 @@ class SPIComponent : public Component {
         return this->hw_spi_->transfer(data);
       } else {
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+        if (this->hw_host_ready_) {
+          this->hw_transfer_(&data, &data, 1);
+          return data;
+        }
+#endif  // USE_SPI_IDF_BACKEND
         return this->transfer_<BIT_ORDER, CLOCK_POLARITY, CLOCK_PHASE, true, true>(data);
 #ifdef USE_SPI_ARDUINO_BACKEND
       }
@@ -203,6 +255,12 @@ class SPIComponent : public Component {
       return;
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
+#ifdef USE_SPI_IDF_BACKEND
+    if (this->hw_host_ready_) {
+      this->hw_transfer_(data, this->miso_ != nullptr ? data : nullptr, length);
+      return;
+    }
+#endif  // USE_SPI_IDF_BACKEND
 
     if (this->miso_ != nullptr) {
       for (size_t i = 0; i < length; i++) {
@@ -233,9 +291,17 @@ class SPIComponent : public Component {
       this->hw_spi_->beginTransaction(settings);
     } else {
 #endif  // USE_SPI_ARDUINO_BACKEND
-      this->clk_->digital_write(CLOCK_POLARITY);
-      uint32_t cpu_freq_hz = arch_get_cpu_freq_hz();
-      this->wait_cycle_ = uint32_t(cpu_freq_hz) / DATA_RATE / 2ULL;
+#ifdef USE_SPI_IDF_BACKEND
+      if (this->hw_host_ready_) {
+        this->hw_enable_((CLOCK_POLARITY ? 2 : 0) | (CLOCK_PHASE ? 1 : 0), BIT_ORDER == BIT_ORDER_LSB_FIRST, DATA_RATE);
+      } else {
+#endif  // USE_SPI_IDF_BACKEND
+        this->clk_->digital_write(CLOCK_POLARITY);
+        uint32_t cpu_freq_hz = arch_get_cpu_freq_hz();
+        this->wait_cycle_ = uint32_t(cpu_freq_hz) / DATA_RATE / 2ULL;
+#ifdef USE_SPI_IDF_BACKEND
+      }
+#endif  // USE_SPI_IDF_BACKEND
 #ifdef USE_SPI_ARDUINO_BACKEND
     }
 #endif  // USE_SPI_ARDUINO_BACKEND
@@ -256,6 +322,26 @@ class SPIComponent : public Component {
   template<SPIBitOrder BIT_ORDER, SPIClockPolarity CLOCK_POLARITY, SPIClockPhase CLOCK_PHASE, bool READ, bool WRITE>
   uint8_t transfer_(uint8_t data);
 
+#ifdef USE_SPI_IDF_BACKEND
+  /// A device on the bus for each combination of mode, bit order and clock the SPIDevices use.
+  struct HWDevice {
+    uint8_t mode;
+    bool lsb_first;
+    uint32_t data_rate;
+    spi_device_handle_t handle;
+  };
+
+  bool hw_setup_(int clk, int miso, int mosi);
+  void hw_enable_(uint8_t mode, bool lsb_first, uint32_t data_rate);
+  /** Transfer length bytes over the bus, either buffer may be null. Does nothing without an acquired device.
+   *
+   * Short transfers are polled to avoid the interrupt and task switch, longer ones are split into DMA chunks
+   * that are all queued at once so the next chunk starts as soon as the previous one is done.
+   */
+  void hw_transfer_(const uint8_t *tx, uint8_t *rx, size_t length);
+  void hw_write_array16_(const uint16_t *data, size_t length);
+#endif  // USE_SPI_IDF_BACKEND
+
   GPIOPin *clk_;
   GPIOPin *miso_{nullptr};
   GPIOPin *mosi_{nullptr};
@@ -263,7 +349,14 @@ class SPIComponent : public Component {
 #ifdef USE_SPI_ARDUINO_BACKEND
   SPIClass *hw_spi_{nullptr};
 #endif  // USE_SPI_ARDUINO_BACKEND
-  uint32_t wait_cycle_;
+#ifdef USE_SPI_IDF_BACKEND
+  spi_host_device_t hw_host_;
+  bool hw_host_ready_{false};
+  std::vector<HWDevice> hw_devices_;
+  /// The device of the current transaction, null when bit-banging or when it could not be acquired.
+  spi_device_handle_t hw_device_{nullptr};
+#endif  // USE_SPI_IDF_BACKEND
+  uint32_t wait_cycle_{0};
 };
 
 template<SPIBitOrder BIT_ORDER, SPIClockPolarity CLOCK_POLARITY, SPIClockPhase CLOCK_PHASE, SPIDataRate DATA_RATE>
@@ -43,6 +43,12 @@ class UARTComponent {
   bool read_byte(uint8_t *data) { return this->read_array(data, 1); };
   virtual bool peek_byte(uint8_t *data) = 0;
   virtual bool read_array(uint8_t *data, size_t len) = 0;
+  /** Read up to max_len bytes that were already received, without waiting for more.
+   *
+   * Returns the number of bytes read. Parsers should prefer this over reading byte by byte, every read goes through
+   * the driver and its lock.
+   */
+  virtual size_t read_available(uint8_t *data, size_t max_len);
 
   /// Return available number of bytes.
   virtual int available() = 0;
@@ -6,6 +6,8 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
+
 #ifdef USE_LOGGER
 #include "esphome/components/logger/logger.h"
 #endif
@@ -179,6 +181,33 @@ bool IDFUARTComponent::read_array(uint8_t *data, size_t len) {
   return true;
 }
 
+size_t IDFUARTComponent::read_available(uint8_t *data, size_t max_len) {
+  if (max_len == 0)
+    return 0;
+  // one lock and one driver call for everything that is buffered, instead of per byte
+  xSemaphoreTake(this->lock_, portMAX_DELAY);
+  size_t len = 0;
+  if (this->has_peek_) {
+    data[len++] = this->peek_byte_;
+    this->has_peek_ = false;
+  }
+  size_t buffered = 0;
+  uart_get_buffered_data_len(this->uart_num_, &buffered);
+  buffered = std::min(buffered, max_len - len);
+  if (buffered > 0) {
+    int read = uart_read_bytes(this->uart_num_, data + len, buffered, 0);
+    if (read > 0)
+      len += read;
+  }
+  xSemaphoreGive(this->lock_);
+#ifdef USE_UART_DEBUGGER
+  for (size_t i = 0; i < len; i++) {
+    this->debug_callback_.call(UART_DIRECTION_RX, data[i]);
+  }
+#endif
+  return len;
+}
+
 int IDFUARTComponent::available() {
   size_t available;
 
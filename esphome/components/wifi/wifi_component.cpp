@@ -1,7 +1,9 @@
 #include "wifi_component.h"
 
 #if defined(USE_ESP32) || defined(USE_ESP_IDF)
+#include <esp_attr.h>
 #include <esp_wifi.h>
+#include <sys/time.h>
 #endif
 #ifdef USE_ESP8266
 #include <user_interface.h>
@@ -31,6 +33,57 @@ namespace wifi {
 
 static const char *const TAG = "wifi";
 
+/// Reconnects that reuse an address before asking DHCP again, so an expired lease isn't kept forever.
+static const uint8_t FAST_RECONNECT_MAX_LEASE_USES = 10;
+/// Upper bound of the time an address is reused for, well below the 8 hours after which the ESP8266 RTC counter wraps.
+static const uint32_t FAST_RECONNECT_MAX_REUSE_S = 4 * 60 * 60;
+
+#ifdef USE_ESP32
+// RTC slow memory survives deep sleep and restarts, and updating it on every boot doesn't wear the flash like NVS
+static RTC_NOINIT_ATTR SavedWifiFastReconnect s_fast_reconnect;  // NOLINT
+static RTC_NOINIT_ATTR uint32_t s_fast_reconnect_check;          // NOLINT
+#endif
+
+/// Read a clock that keeps running through deep sleep and restarts, returns false if there is none.
+static bool fast_reconnect_clock(uint64_t *now) {
+#ifdef USE_ESP8266
+  // RTC ticks, they keep counting through deep sleep but restart with any other reset, see
+  // fast_reconnect_clock_restarted()
+  *now = system_get_rtc_time();
+  return true;
+#elif defined(USE_ESP32)
+  // the system time is kept by the RTC in deep sleep
+  struct timeval tv {};
+  gettimeofday(&tv, nullptr);
+  *now = static_cast<uint64_t>(tv.tv_sec) * 1000000ULL + tv.tv_usec;
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// Whether fast_reconnect_clock() started over with this boot, so earlier readings can't be compared to it.
+static bool fast_reconnect_clock_restarted() {
+#ifdef USE_ESP8266
+  return system_get_rst_info()->reason != REASON_DEEP_SLEEP_AWAKE;
+#else
+  return false;
+#endif
+}
+
+/// Seconds between two fast_reconnect_clock() readings.
+static uint32_t fast_reconnect_elapsed_s(uint64_t since, uint64_t now) {
+#ifdef USE_ESP8266
+  const uint32_t ticks = static_cast<uint32_t>(now) - static_cast<uint32_t>(since);
+  return ((static_cast<uint64_t>(ticks) * system_rtc_clock_cali_proc()) >> 12) / 1000000ULL;
+#else
+  // the clock was set (by SNTP for example) in between, so the time that passed is unknown
+  if (now < since)
+    return UINT32_MAX;
+  return std::min<uint64_t>((now - since) / 1000000ULL, UINT32_MAX);
+#endif
+}
+
 float WiFiComponent::get_setup_priority() const { return setup_priority::WIFI; }
 
 void WiFiComponent::setup() {
@@ -63,7 +116,19 @@ void WiFiComponent::setup() {
       ESP_LOGV(TAG, "Setting Power Save Option failed!");
     }
 
-    if (this->fast_connect_) {
+    if (this->fast_reconnect_) {
+      // kept in RTC memory, so it survives deep sleep without wearing the flash
+#ifdef USE_ESP32
+      this->fast_reconnect_type_ = hash ^ 0x46524354UL;
+#else
+      this->fast_reconnect_pref_ =
+          global_preferences->make_preference<wifi::SavedWifiFastReconnect>(hash ^ 0x46524354UL, false);
+#endif
+    }
+    if (this->load_fast_reconnect_()) {
+      this->fast_reconnect_attempt_ = true;
+      this->start_connecting(this->selected_ap_, false);
+    } else if (this->fast_connect_) {
       this->selected_ap_ = this->sta_[0];
       this->start_connecting(this->selected_ap_, false);
     } else {
@@ -128,6 +193,8 @@ void WiFiComponent::loop() {
         } else {
           this->status_clear_warning();
           this->last_connected_ = now;
+          if (this->fast_reconnect_)
+            this->check_fast_reconnect_lease_();
         }
         break;
       }
@@ -253,6 +320,162 @@ void WiFiComponent::save_wifi_sta(const std::string &ssid, const std::string &pa
   this->set_sta(sta);
 }
 
+bool WiFiComponent::read_fast_reconnect_(SavedWifiFastReconnect *save) {
+#ifdef USE_ESP32
+  const uint32_t check =
+      fnv1_hash(std::string(reinterpret_cast<const char *>(&s_fast_reconnect), sizeof(s_fast_reconnect)));
+  if (s_fast_reconnect_check != (check ^ this->fast_reconnect_type_))
+    return false;
+  *save = s_fast_reconnect;
+  return true;
+#else
+  return this->fast_reconnect_pref_.load(save);
+#endif
+}
+
+void WiFiComponent::write_fast_reconnect_(const SavedWifiFastReconnect &save) {
+#ifdef USE_ESP32
+  s_fast_reconnect = save;
+  s_fast_reconnect_check =
+      fnv1_hash(std::string(reinterpret_cast<const char *>(&save), sizeof(save))) ^ this->fast_reconnect_type_;
+#else
+  this->fast_reconnect_pref_.save(&save);
+#endif
+}
+
+bool WiFiComponent::load_fast_reconnect_() {
+  if (!this->fast_reconnect_ || !this->read_fast_reconnect_(&this->fast_reconnect_save_))
+    return false;
+  auto &save = this->fast_reconnect_save_;
+  if (fast_reconnect_clock_restarted()) {
+    save.clock_epoch++;
+    this->write_fast_reconnect_(save);
+  }
+  if (save.sta_index >= this->sta_.size())
+    return false;
+  const WiFiAP &config = this->sta_[save.sta_index];
+  if (config.get_hidden() || fnv1_hash(config.get_ssid()) != save.ssid_hash)
+    return false;
+
+  WiFiAP params = config;
+  bssid_t bssid;
+  std::copy(save.bssid, save.bssid + 6, bssid.begin());
+  params.set_bssid(bssid);
+  params.set_channel(save.channel);
+  uint64_t now;
+  const bool reuse_ip = !config.get_manual_ip().has_value() && save.ip != 0 &&
+                        save.lease_uses < FAST_RECONNECT_MAX_LEASE_USES && save.lease_epoch == save.clock_epoch &&
+                        fast_reconnect_clock(&now) &&
+                        fast_reconnect_elapsed_s(save.lease_clock, now) < save.lease_reuse_s;
+  if (reuse_ip) {
+    // skip DHCP by using the address of the last lease
+    ManualIP manual_ip{};
+    manual_ip.static_ip = save.ip;
+    manual_ip.gateway = save.gateway;
+    manual_ip.subnet = save.subnet;
+    manual_ip.dns1 = save.dns1;
+    manual_ip.dns2 = save.dns2;
+    params.set_manual_ip(manual_ip);
+    save.lease_uses++;
+    this->write_fast_reconnect_(save);
+  }
+  ESP_LOGD(TAG, "Reconnecting to cached access point %s on channel %u%s", format_mac_addr(save.bssid).c_str(),
+           save.channel, reuse_ip ? " reusing IP" : "");
+  this->selected_ap_ = params;
+  return true;
+}
+
+void WiFiComponent::save_fast_reconnect_() {
+  if (!this->fast_reconnect_)
+    return;
+  const std::string ssid = this->selected_ap_.get_ssid();
+  uint8_t index = 0;
+  while (index < this->sta_.size() && this->sta_[index].get_ssid() != ssid)
+    index++;
+  if (index >= this->sta_.size() || this->sta_[index].get_hidden())
+    return;
+
+  SavedWifiFastReconnect save{};
+  save.ssid_hash = fnv1_hash(ssid);
+  bssid_t bssid = this->wifi_bssid();
+  std::copy(bssid.begin(), bssid.end(), save.bssid);
+  save.channel = static_cast<uint8_t>(this->wifi_channel_());
+  save.sta_index = index;
+  save.clock_epoch = this->fast_reconnect_save_.clock_epoch;
+  // with a configured address there's no lease to remember
+  const bool dhcp = !this->sta_[index].get_manual_ip().has_value();
+  if (dhcp && this->selected_ap_.get_manual_ip().has_value()) {
+    // the address is still the reused one, keep counting its uses
+    save.ip = this->fast_reconnect_save_.ip;
+    save.gateway = this->fast_reconnect_save_.gateway;
+    save.subnet = this->fast_reconnect_save_.subnet;
+    save.dns1 = this->fast_reconnect_save_.dns1;
+    save.dns2 = this->fast_reconnect_save_.dns2;
+    save.lease_uses = this->fast_reconnect_save_.lease_uses;
+    save.lease_clock = this->fast_reconnect_save_.lease_clock;
+    save.lease_reuse_s = this->fast_reconnect_save_.lease_reuse_s;
+    save.lease_epoch = this->fast_reconnect_save_.lease_epoch;
+  } else if (dhcp) {
+    // without the lease time or a clock that runs through deep sleep, it can't be known when the address expires
+    const uint32_t lease_time = this->wifi_dhcp_lease_time_();
+    uint64_t now;
+    if (lease_time != 0 && fast_reconnect_clock(&now)) {
+      save.lease_clock = now;
+      save.ip = this->wifi_sta_ip();
+      save.gateway = this->wifi_gateway_ip_();
+      save.subnet = this->wifi_subnet_mask_();
+      save.dns1 = this->wifi_dns_ip_(0);
+      save.dns2 = this->wifi_dns_ip_(1);
+      save.lease_reuse_s = std::min(lease_time / 2, FAST_RECONNECT_MAX_REUSE_S);
+      save.lease_epoch = save.clock_epoch;
+    }
+  }
+  if (memcmp(&save, &this->fast_reconnect_save_, sizeof(save)) == 0)
+    return;
+  this->fast_reconnect_save_ = save;
+  this->write_fast_reconnect_(save);
+}
+
+void WiFiComponent::check_fast_reconnect_lease_() {
+  if ((millis() - this->fast_reconnect_checked_) < 60000)
+    return;
+  this->fast_reconnect_checked_ = millis();
+  auto &save = this->fast_reconnect_save_;
+  if (this->fast_reconnect_dhcp_pending_) {
+    this->save_fast_reconnect_();
+    this->fast_reconnect_dhcp_pending_ = save.ip == 0;
+    return;
+  }
+  if (save.ip == 0)
+    return;
+  uint64_t now;
+  if (save.lease_epoch == save.clock_epoch && fast_reconnect_clock(&now) &&
+      fast_reconnect_elapsed_s(save.lease_clock, now) < save.lease_reuse_s)
+    return;
+
+  // this also keeps the elapsed time within range of the ESP8266 RTC counter
+  save.ip = 0;
+  this->write_fast_reconnect_(save);
+  if (this->selected_ap_.get_manual_ip().has_value()) {
+    // the reused address was never renewed, so it may not be kept any longer than it would be cached
+    ESP_LOGD(TAG, "Reused address expired, requesting a new lease");
+    this->selected_ap_.set_manual_ip({});
+    this->wifi_sta_ip_config_({});
+    this->fast_reconnect_dhcp_pending_ = true;
+  } else {
+    // DHCP renews the lease by itself, remember it again from now on
+    this->save_fast_reconnect_();
+  }
+}
+
+void WiFiComponent::forget_fast_reconnect_() {
+  ESP_LOGW(TAG, "Connecting to the cached access point failed, forgetting it");
+  this->fast_reconnect_attempt_ = false;
+  this->fast_reconnect_save_ = SavedWifiFastReconnect{};
+  this->fast_reconnect_save_.sta_index = UINT8_MAX;
+  this->write_fast_reconnect_(this->fast_reconnect_save_);
+}
+
 void WiFiComponent::start_connecting(const WiFiAP &ap, bool two) {
   ESP_LOGI(TAG, "WiFi Connecting to '%s'...", ap.get_ssid().c_str());
 #ifdef ESPHOME_LOG_HAS_VERBOSE
@@ -517,6 +740,10 @@ void WiFiComponent::check_connecting_finished() {
 
     ESP_LOGI(TAG, "WiFi Connected!");
     this->print_connect_params_();
+    ESP_LOGD(TAG, "Connected %u ms after boot%s", millis(),
+             this->fast_reconnect_attempt_ ? " using the cached access point" : "");
+    this->save_fast_reconnect_();
+    this->fast_reconnect_attempt_ = false;
 
     if (this->has_ap()) {
 #ifdef USE_CAPTIVE_PORTAL
@@ -572,6 +799,18 @@ void WiFiComponent::check_connecting_finished() {
 }
 
 void WiFiComponent::retry_connect() {
+  if (this->fast_reconnect_attempt_) {
+    // the access point may have moved to another channel or the address is taken, start over the usual way
+    this->forget_fast_reconnect_();
+    if (this->fast_connect_) {
+      this->selected_ap_ = this->sta_[0];
+      this->start_connecting(this->selected_ap_, false);
+    } else {
+      this->start_scanning();
+    }
+    return;
+  }
+
   if (this->selected_ap_.get_bssid()) {
     auto bssid = *this->selected_ap_.get_bssid();
     float priority = this->get_sta_priority(bssid);
@@ -44,6 +44,30 @@ struct SavedWifiSettings {
   char password[65];
 } PACKED;  // NOLINT
 
+/// The last successful connection, to connect straight to it after a reboot or deep sleep.
+struct SavedWifiFastReconnect {
+  uint32_t ssid_hash;
+  uint8_t bssid[6];
+  uint8_t channel;
+  /// Index of the network in the configuration, UINT8_MAX if nothing is cached.
+  uint8_t sta_index;
+  /// Address assigned by DHCP, 0 if the network uses a static IP.
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns1;
+  uint32_t dns2;
+  /// Connections that reused the address since it was last assigned by DHCP.
+  uint8_t lease_uses;
+  /// Reading of the clock that keeps running through deep sleep when the address was assigned.
+  uint64_t lease_clock;
+  /// Seconds after lease_clock the address may be reused, half the lease like the DHCP renewal time.
+  uint32_t lease_reuse_s;
+  /// Incremented whenever the clock was restarted, lease_clock is only comparable while this matches lease_epoch.
+  uint32_t clock_epoch;
+  uint32_t lease_epoch;
+} PACKED;  // NOLINT
+
 enum WiFiComponentState {
   /** Nothing has been initialized yet. Internal AP, if configured, is disabled at this point. */
   WIFI_COMPONENT_STATE_OFF = 0,
@@ -202,6 +226,7 @@ class WiFiComponent : public Component {
   void check_scanning_finished();
   void start_connecting(const WiFiAP &ap, bool two);
   void set_fast_connect(bool fast_connect);
+  void set_fast_reconnect(bool fast_reconnect) { fast_reconnect_ = fast_reconnect; }
   void set_ap_timeout(uint32_t ap_timeout) { ap_timeout_ = ap_timeout; }
 
   void check_connecting_finished();
@@ -283,6 +308,14 @@ class WiFiComponent : public Component {
   static std::string format_mac_addr(const uint8_t mac[6]);
   void setup_ap_config_();
   void print_connect_params_();
+  /// Set selected_ap_ to the cached connection, returns false if there is none for the configured networks.
+  bool load_fast_reconnect_();
+  void save_fast_reconnect_();
+  void forget_fast_reconnect_();
+  /// Forget the cached address once the time it may be reused for is over.
+  void check_fast_reconnect_lease_();
+  bool read_fast_reconnect_(SavedWifiFastReconnect *save);
+  void write_fast_reconnect_(const SavedWifiFastReconnect &save);
 
   void wifi_loop_();
   bool wifi_mode_(optional<bool> sta, optional<bool> ap);
@@ -302,6 +335,8 @@ class WiFiComponent : public Component {
   network::IPAddress wifi_subnet_mask_();
   network::IPAddress wifi_gateway_ip_();
   network::IPAddress wifi_dns_ip_(int num);
+  /// Lease time of the DHCP address in seconds, 0 if unknown.
+  uint32_t wifi_dhcp_lease_time_();
 
   bool is_captive_portal_active_();
   bool is_esp32_improv_active_();
@@ -334,6 +369,13 @@ class WiFiComponent : public Component {
   std::vector<WiFiSTAPriority> sta_priorities_;
   WiFiAP selected_ap_;
   bool fast_connect_{false};
+  bool fast_reconnect_{false};
+  /// Whether the current connection attempt uses the cached connection.
+  bool fast_reconnect_attempt_{false};
+  SavedWifiFastReconnect fast_reconnect_save_{};
+  uint32_t fast_reconnect_checked_{0};
+  /// DHCP was started after the reused address expired, its lease is remembered once it is bound.
+  bool fast_reconnect_dhcp_pending_{false};
 
   bool has_ap_{false};
   WiFiAP ap_;
@@ -350,6 +392,11 @@ class WiFiComponent : public Component {
   bool ap_setup_{false};
   optional<float> output_power_;
   ESPPreferenceObject pref_;
+#ifdef USE_ESP32
+  uint32_t fast_reconnect_type_{0};
+#else
+  ESPPreferenceObject fast_reconnect_pref_;
+#endif
   bool has_saved_wifi_settings_{false};
 #ifdef USE_WIFI_11KV_SUPPORT
   bool btm_{false};
@@ -12,6 +12,8 @@
 #include "lwip/err.h"
 #include "lwip/dns.h"
 #include "lwip/apps/sntp.h"
+#include "lwip/dhcp.h"
+#include <esp_netif_net_stack.h>
 
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
@@ -764,6 +766,15 @@ int32_t WiFiComponent::wifi_channel_() { return WiFi.channel(); }
 network::IPAddress WiFiComponent::wifi_subnet_mask_() { return {WiFi.subnetMask()}; }
 network::IPAddress WiFiComponent::wifi_gateway_ip_() { return {WiFi.gatewayIP()}; }
 network::IPAddress WiFiComponent::wifi_dns_ip_(int num) { return {WiFi.dnsIP(num)}; }
+uint32_t WiFiComponent::wifi_dhcp_lease_time_() {
+  esp_netif_t *sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+  if (sta == nullptr)
+    return 0;
+  auto *intf = static_cast<struct netif *>(esp_netif_get_netif_impl(sta));
+  if (intf == nullptr || netif_dhcp_data(intf) == nullptr)
+    return 0;
+  return netif_dhcp_data(intf)->offered_t0_lease;
+}
 void WiFiComponent::wifi_loop_() {}
 
 }  // namespace wifi
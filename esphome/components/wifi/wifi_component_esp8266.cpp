@@ -787,6 +787,16 @@ int32_t WiFiComponent::wifi_channel_() { return WiFi.channel(); }
 network::IPAddress WiFiComponent::wifi_subnet_mask_() { return {WiFi.subnetMask()}; }
 network::IPAddress WiFiComponent::wifi_gateway_ip_() { return {WiFi.gatewayIP()}; }
 network::IPAddress WiFiComponent::wifi_dns_ip_(int num) { return {WiFi.dnsIP(num)}; }
+uint32_t WiFiComponent::wifi_dhcp_lease_time_() {
+#if LWIP_VERSION_MAJOR != 1
+  struct netif *intf = eagle_lwip_getif(STATION_IF);
+  if (intf == nullptr || netif_dhcp_data(intf) == nullptr)
+    return 0;
+  return netif_dhcp_data(intf)->offered_t0_lease;
+#else
+  return 0;
+#endif
+}
 void WiFiComponent::wifi_loop_() {}
 
 }  // namespace wifi
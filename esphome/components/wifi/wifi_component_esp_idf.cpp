@@ -18,6 +18,8 @@
 #endif
 #include "lwip/err.h"
 #include "lwip/dns.h"
+#include "lwip/dhcp.h"
+#include <esp_netif_net_stack.h>
 
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
@@ -914,6 +916,12 @@ network::IPAddress WiFiComponent::wifi_dns_ip_(int num) {
   const ip_addr_t *dns_ip = dns_getserver(num);
   return {dns_ip->u_addr.ip4.addr};
 }
+uint32_t WiFiComponent::wifi_dhcp_lease_time_() {
+  auto *intf = static_cast<struct netif *>(esp_netif_get_netif_impl(s_sta_netif));
+  if (intf == nullptr || netif_dhcp_data(intf) == nullptr)
+    return 0;
+  return netif_dhcp_data(intf)->offered_t0_lease;
+}
 
 }  // namespace wifi
 }  // namespace esphome
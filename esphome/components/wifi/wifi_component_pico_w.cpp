@@ -176,6 +176,8 @@ network::IPAddress WiFiComponent::wifi_dns_ip_(int num) {
   const ip_addr_t *dns_ip = dns_getserver(num);
   return {dns_ip->addr};
 }
+// there's no clock that runs through a reset to tell when the lease expires, so it isn't reused
+uint32_t WiFiComponent::wifi_dhcp_lease_time_() { return 0; }
 
 void WiFiComponent::wifi_loop_() {
   if (this->state_ == WIFI_COMPONENT_STATE_STA_SCANNING && !cyw43_wifi_scan_active(&cyw43_state)) {
@@ -4,6 +4,8 @@
 
 #ifdef USE_ESP32
 
+#include <cstring>
+#include <memory>
 #include <vector>
 #include "mbedtls/ccm.h"
 
@@ -231,6 +233,36 @@ optional<XiaomiParseResult> parse_xiaomi_header(const esp32_ble_tracker::Service
   return result;
 }
 
+/// A CCM context with its bindkey already expanded.
+struct XiaomiCipher {
+  uint8_t key[16];
+  mbedtls_ccm_context ctx;
+};
+
+/** The cipher for a bindkey, set up on first use.
+ *
+ * Bindkeys are fixed at compile time, so the contexts are kept for the lifetime of the program instead of running
+ * the key setup for every advertisement. Only called from the main loop.
+ */
+static mbedtls_ccm_context *get_xiaomi_cipher(const uint8_t *bindkey) {
+  static std::vector<std::unique_ptr<XiaomiCipher>> ciphers;  // NOLINT
+  for (auto &cipher : ciphers) {
+    if (memcmp(cipher->key, bindkey, sizeof(cipher->key)) == 0)
+      return &cipher->ctx;
+  }
+
+  auto cipher = make_unique<XiaomiCipher>();
+  memcpy(cipher->key, bindkey, sizeof(cipher->key));
+  mbedtls_ccm_init(&cipher->ctx);
+  if (mbedtls_ccm_setkey(&cipher->ctx, MBEDTLS_CIPHER_ID_AES, cipher->key, sizeof(cipher->key) * 8) != 0) {
+    ESP_LOGVV(TAG, "decrypt_xiaomi_payload(): mbedtls_ccm_setkey() failed.");
+    mbedtls_ccm_free(&cipher->ctx);
+    return nullptr;
+  }
+  ciphers.push_back(std::move(cipher));
+  return &ciphers.back()->ctx;
+}
+
 bool decrypt_xiaomi_payload(std::vector<uint8_t> &raw, const uint8_t *bindkey, const uint64_t &address) {
   if (!((raw.size() == 19) || ((raw.size() >= 22) && (raw.size() <= 24)))) {
     ESP_LOGVV(TAG, "decrypt_xiaomi_payload(): data packet has wrong size (%d)!", raw.size());
@@ -238,84 +270,52 @@ bool decrypt_xiaomi_payload(std::vector<uint8_t> &raw, const uint8_t *bindkey, c
     return false;
   }
 
-  uint8_t mac_reverse[6] = {0};
-  mac_reverse[5] = (uint8_t)(address >> 40);
-  mac_reverse[4] = (uint8_t)(address >> 32);
-  mac_reverse[3] = (uint8_t)(address >> 24);
-  mac_reverse[2] = (uint8_t)(address >> 16);
-  mac_reverse[1] = (uint8_t)(address >> 8);
-  mac_reverse[0] = (uint8_t)(address >> 0);
-
-  XiaomiAESVector vector{.key = {0},
-                         .plaintext = {0},
-                         .ciphertext = {0},
-                         .authdata = {0x11},
-                         .iv = {0},
-                         .tag = {0},
-                         .keysize = 16,
-                         .authsize = 1,
-                         .datasize = 0,
-                         .tagsize = 4,
-                         .ivsize = 12};
-
-  vector.datasize = (raw.size() == 19) ? raw.size() - 12 : raw.size() - 18;
-  int cipher_pos = (raw.size() == 19) ? 5 : 11;
-
-  const uint8_t *v = raw.data();
-
-  memcpy(vector.key, bindkey, vector.keysize);
-  memcpy(vector.ciphertext, v + cipher_pos, vector.datasize);
-  memcpy(vector.tag, v + raw.size() - vector.tagsize, vector.tagsize);
-  memcpy(vector.iv, mac_reverse, 6);             // MAC address reverse
-  memcpy(vector.iv + 6, v + 2, 3);               // sensor type (2) + packet id (1)
-  memcpy(vector.iv + 9, v + raw.size() - 7, 3);  // payload counter
-
-  mbedtls_ccm_context ctx;
-  mbedtls_ccm_init(&ctx);
-
-  int ret = mbedtls_ccm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, vector.key, vector.keysize * 8);
-  if (ret) {
-    ESP_LOGVV(TAG, "decrypt_xiaomi_payload(): mbedtls_ccm_setkey() failed.");
-    mbedtls_ccm_free(&ctx);
+  mbedtls_ccm_context *ctx = get_xiaomi_cipher(bindkey);
+  if (ctx == nullptr)
     return false;
-  }
 
-  ret = mbedtls_ccm_auth_decrypt(&ctx, vector.datasize, vector.iv, vector.ivsize, vector.authdata, vector.authsize,
-                                 vector.ciphertext, vector.plaintext, vector.tag, vector.tagsize);
+  static const uint8_t AUTHDATA[1] = {0x11};
+  static const size_t TAG_SIZE = 4;
+  const size_t datasize = (raw.size() == 19) ? raw.size() - 12 : raw.size() - 18;
+  const size_t cipher_pos = (raw.size() == 19) ? 5 : 11;
+  uint8_t *v = raw.data();
+
+  uint8_t iv[12];
+  iv[0] = (uint8_t)(address >> 0);  // MAC address reverse
+  iv[1] = (uint8_t)(address >> 8);
+  iv[2] = (uint8_t)(address >> 16);
+  iv[3] = (uint8_t)(address >> 24);
+  iv[4] = (uint8_t)(address >> 32);
+  iv[5] = (uint8_t)(address >> 40);
+  memcpy(iv + 6, v + 2, 3);               // sensor type (2) + packet id (1)
+  memcpy(iv + 9, v + raw.size() - 7, 3);  // payload counter
+
+  // mbedtls wipes the output when authentication fails, so only overwrite the payload once it passed
+  uint8_t plaintext[16];
+  int ret = mbedtls_ccm_auth_decrypt(ctx, datasize, iv, sizeof(iv), AUTHDATA, sizeof(AUTHDATA), v + cipher_pos,
+                                     plaintext, v + raw.size() - TAG_SIZE, TAG_SIZE);
   if (ret) {
-    uint8_t mac_address[6] = {0};
-    memcpy(mac_address, mac_reverse + 5, 1);
-    memcpy(mac_address + 1, mac_reverse + 4, 1);
-    memcpy(mac_address + 2, mac_reverse + 3, 1);
-    memcpy(mac_address + 3, mac_reverse + 2, 1);
-    memcpy(mac_address + 4, mac_reverse + 1, 1);
-    memcpy(mac_address + 5, mac_reverse, 1);
+    const uint8_t mac_address[6] = {iv[5], iv[4], iv[3], iv[2], iv[1], iv[0]};
     ESP_LOGVV(TAG, "decrypt_xiaomi_payload(): authenticated decryption failed.");
     ESP_LOGVV(TAG, "  MAC address : %s", format_hex_pretty(mac_address, 6).c_str());
     ESP_LOGVV(TAG, "       Packet : %s", format_hex_pretty(raw.data(), raw.size()).c_str());
-    ESP_LOGVV(TAG, "          Key : %s", format_hex_pretty(vector.key, vector.keysize).c_str());
-    ESP_LOGVV(TAG, "           Iv : %s", format_hex_pretty(vector.iv, vector.ivsize).c_str());
-    ESP_LOGVV(TAG, "       Cipher : %s", format_hex_pretty(vector.ciphertext, vector.datasize).c_str());
-    ESP_LOGVV(TAG, "          Tag : %s", format_hex_pretty(vector.tag, vector.tagsize).c_str());
-    mbedtls_ccm_free(&ctx);
+    ESP_LOGVV(TAG, "          Key : %s", format_hex_pretty(bindkey, 16).c_str());
+    ESP_LOGVV(TAG, "           Iv : %s", format_hex_pretty(iv, sizeof(iv)).c_str());
+    ESP_LOGVV(TAG, "       Cipher : %s", format_hex_pretty(v + cipher_pos, datasize).c_str());
+    ESP_LOGVV(TAG, "          Tag : %s", format_hex_pretty(v + raw.size() - TAG_SIZE, TAG_SIZE).c_str());
     return false;
   }
 
   // replace encrypted payload with plaintext
-  uint8_t *p = vector.plaintext;
-  for (std::vector<uint8_t>::iterator it = raw.begin() + cipher_pos; it != raw.begin() + cipher_pos + vector.datasize;
-       ++it) {
-    *it = *(p++);
-  }
+  memcpy(v + cipher_pos, plaintext, datasize);
 
   // clear encrypted flag
   raw[0] &= ~0x08;
 
   ESP_LOGVV(TAG, "decrypt_xiaomi_payload(): authenticated decryption passed.");
-  ESP_LOGVV(TAG, "  Plaintext : %s, Packet : %d", format_hex_pretty(raw.data() + cipher_pos, vector.datasize).c_str(),
+  ESP_LOGVV(TAG, "  Plaintext : %s, Packet : %d", format_hex_pretty(raw.data() + cipher_pos, datasize).c_str(),
             static_cast<int>(raw[4]));
 
-  mbedtls_ccm_free(&ctx);
   return true;
 }
 
@@ -51,20 +51,6 @@ struct XiaomiParseResult {
   int raw_offset;
 };
 
-struct XiaomiAESVector {
-  uint8_t key[16];
-  uint8_t plaintext[16];
-  uint8_t ciphertext[16];
-  uint8_t authdata[16];
-  uint8_t iv[16];
-  uint8_t tag[16];
-  size_t keysize;
-  size_t authsize;
-  size_t datasize;
-  size_t tagsize;
-  size_t ivsize;
-};
-
 bool parse_xiaomi_value(uint16_t value_type, const uint8_t *data, uint8_t value_length, XiaomiParseResult &result);
 bool parse_xiaomi_message(const std::vector<uint8_t> &message, XiaomiParseResult &result);
 optional<XiaomiParseResult> parse_xiaomi_header(const esp32_ble_tracker::ServiceData &service_data);
@@ -7,6 +7,10 @@
 #include "esphome/components/status_led/status_led.h"
 #endif
 
+#ifdef USE_DEEP_SLEEP_PROFILE
+#include "esphome/components/deep_sleep/deep_sleep_component.h"
+#endif
+
 namespace esphome {
 
 static const char *const TAG = "app";
@@ -34,12 +38,19 @@ void Application::setup() {
 
   for (uint32_t i = 0; i < this->components_.size(); i++) {
     Component *component = this->components_[i];
+#ifdef USE_DEEP_SLEEP_PROFILE
+    const uint32_t setup_started = millis();
+#endif
 
     component->call();
     this->scheduler.process_to_add();
     this->feed_wdt();
-    if (component->can_proceed())
+    if (component->can_proceed()) {
+#ifdef USE_DEEP_SLEEP_PROFILE
+      deep_sleep::record_setup_duration(component, millis() - setup_started);
+#endif
       continue;
+    }
 
     std::stable_sort(this->components_.begin(), this->components_.begin() + i + 1,
                      [](Component *a, Component *b) { return a->get_loop_priority() > b->get_loop_priority(); });
@@ -57,6 +68,9 @@ void Application::setup() {
       this->app_state_ = new_app_state;
       yield();
     } while (!component->can_proceed());
+#ifdef USE_DEEP_SLEEP_PROFILE
+    deep_sleep::record_setup_duration(component, millis() - setup_started);
+#endif
   }
 
   ESP_LOGI(TAG, "setup() finished successfully!");
@@ -65,6 +79,7 @@ void Application::setup() {
 }
 void Application::loop() {
   uint32_t new_app_state = 0;
+  const uint32_t loop_start = micros();
 
   this->scheduler.call();
   this->feed_wdt();
@@ -78,6 +93,7 @@ void Application::loop() {
     this->feed_wdt();
   }
   this->app_state_ = new_app_state;
+  this->loop_time_us_ = micros() - loop_start;
 
   const uint32_t now = millis();
 
@@ -178,6 +178,9 @@ class Application {
 
   uint32_t get_app_state() const { return this->app_state_; }
 
+  /// Time the last loop() iteration spent in the scheduler and components, in microseconds.
+  uint32_t get_loop_time_us() const { return this->loop_time_us_; }
+
 #ifdef USE_BINARY_SENSOR
   const std::vector<binary_sensor::BinarySensor *> &get_binary_sensors() { return this->binary_sensors_; }
   binary_sensor::BinarySensor *get_binary_sensor_by_key(uint32_t key, bool include_internal = false) {
@@ -356,6 +359,7 @@ class Application {
   std::string compilation_time_;
   bool name_add_mac_suffix_;
   uint32_t last_loop_{0};
+  uint32_t loop_time_us_{0};
   uint32_t loop_interval_{16};
   size_t dump_config_at_{SIZE_MAX};
   uint32_t app_state_{0};
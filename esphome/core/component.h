@@ -117,6 +117,12 @@ class Component {
    */
   virtual void mark_failed();
 
+  /** Don't call setup() and loop() of this component in this run of the firmware, without flagging an error.
+   *
+   * Has to be called before Application::setup(), deep_sleep uses it to skip components on timer wakeups.
+   */
+  void skip_setup();
+
   bool is_failed();
 
   virtual bool can_proceed();
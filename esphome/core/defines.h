@@ -88,6 +88,7 @@
 #define USE_ADC_SENSOR_VCC
 #define USE_ARDUINO_VERSION_CODE VERSION_CODE(3, 0, 2)
 #define USE_ESP8266_PREFERENCES_FLASH
+#define USE_ESP8266_PREFERENCES_SECTORS 2
 #define USE_HTTP_REQUEST_ESP8266_HTTPS
 #define USE_SOCKET_IMPL_LWIP_TCP
 
@@ -1,17 +1,38 @@
 #include "esphome/core/entity_base.h"
 #include "esphome/core/helpers.h"
 
+#include <cstring>
+
 namespace esphome {
 
 static const char *const TAG = "entity_base";
 
-EntityBase::EntityBase(std::string name) : name_(std::move(name)) { this->calc_object_id_(); }
+// Copy a runtime string into a heap buffer owned by the Entity. Entities are never destroyed, so the buffer only
+// needs to be released when it's replaced.
+static char *copy_string(const char *str, size_t len) {
+  char *copy = new char[len + 1];  // NOLINT(cppcoreguidelines-owning-memory)
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  return copy;
+}
 
 // Entity Name
-const std::string &EntityBase::get_name() const { return this->name_; }
+const StringRef &EntityBase::get_name() const { return this->name_; }
+void EntityBase::set_name(const char *name) {
+  if (this->has_own_name_)
+    delete[] this->name_.c_str();  // NOLINT(cppcoreguidelines-owning-memory)
+  this->name_ = StringRef(name);
+  this->has_own_name_ = false;
+  // recalculated from the new name on first use, unless the code generator sets it
+  this->set_object_id(nullptr);
+}
 void EntityBase::set_name(const std::string &name) {
-  this->name_ = name;
-  this->calc_object_id_();
+  if (name.empty()) {
+    this->set_name("");
+    return;
+  }
+  this->set_name(copy_string(name.c_str(), name.size()));
+  this->has_own_name_ = true;
 }
 
 // Entity Internal
@@ -23,22 +44,48 @@ bool EntityBase::is_disabled_by_default() const { return this->disabled_by_defau
 void EntityBase::set_disabled_by_default(bool disabled_by_default) { this->disabled_by_default_ = disabled_by_default; }
 
 // Entity Icon
-const std::string &EntityBase::get_icon() const { return this->icon_; }
-void EntityBase::set_icon(const std::string &name) { this->icon_ = name; }
+StringRef EntityBase::get_icon() const {
+  if (this->icon_c_str_ == nullptr)
+    return StringRef();
+  return StringRef(this->icon_c_str_);
+}
+void EntityBase::set_icon(const char *icon) { this->icon_c_str_ = icon; }
 
 // Entity Category
 EntityCategory EntityBase::get_entity_category() const { return this->entity_category_; }
 void EntityBase::set_entity_category(EntityCategory entity_category) { this->entity_category_ = entity_category; }
 
 // Entity Object ID
-const std::string &EntityBase::get_object_id() { return this->object_id_; }
+StringRef EntityBase::get_object_id() {
+  if (this->object_id_c_str_ == nullptr)
+    this->calc_object_id_();
+  return StringRef(this->object_id_c_str_);
+}
+void EntityBase::set_object_id(const char *object_id) {
+  if (this->has_own_object_id_)
+    delete[] this->object_id_c_str_;  // NOLINT(cppcoreguidelines-owning-memory)
+  this->object_id_c_str_ = object_id;
+  this->has_own_object_id_ = false;
+  if (object_id != nullptr) {
+    // FNV-1 hash
+    this->object_id_hash_ = fnv1_hash(object_id);
+  }
+}
 
-// Calculate Object ID Hash from Entity Name
+// Calculate Object ID from Entity Name, only needed for entities named at runtime.
 void EntityBase::calc_object_id_() {
-  this->object_id_ = str_sanitize(str_snake_case(this->name_));
-  // FNV-1 hash
-  this->object_id_hash_ = fnv1_hash(this->object_id_);
+  if (this->name_.empty()) {
+    this->set_object_id("");
+    return;
+  }
+  std::string object_id = str_sanitize(str_snake_case(this->name_));
+  this->set_object_id(copy_string(object_id.c_str(), object_id.size()));
+  this->has_own_object_id_ = true;
+}
+uint32_t EntityBase::get_object_id_hash() {
+  if (this->object_id_c_str_ == nullptr)
+    this->calc_object_id_();
+  return this->object_id_hash_;
 }
-uint32_t EntityBase::get_object_id_hash() { return this->object_id_hash_; }
 
 }  // namespace esphome
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstdint>
+#include "string_ref.h"
 
 namespace esphome {
 
@@ -14,15 +15,19 @@ enum EntityCategory : uint8_t {
 // The generic Entity base class that provides an interface common to all Entities.
 class EntityBase {
  public:
-  EntityBase() : EntityBase("") {}
-  explicit EntityBase(std::string name);
+  EntityBase() { this->set_name(""); }
+  explicit EntityBase(const std::string &name) { this->set_name(name); }
 
-  // Get/set the name of this Entity
-  const std::string &get_name() const;
+  // Get/set the name of this Entity. The const char * overload stores the pointer, so the string must outlive
+  // the Entity (like the string literals emitted by the code generator), the std::string overload copies it.
+  const StringRef &get_name() const;
+  void set_name(const char *name);
   void set_name(const std::string &name);
 
-  // Get the sanitized name of this Entity as an ID. Caching it internally.
-  const std::string &get_object_id();
+  // Get the sanitized name of this Entity as an ID. Set by the code generator, or calculated from the name on first
+  // use. Like set_name(const char *), set_object_id() stores the pointer.
+  StringRef get_object_id();
+  void set_object_id(const char *object_id);
 
   // Get the unique Object ID of this Entity
   uint32_t get_object_id_hash();
@@ -42,8 +47,8 @@ class EntityBase {
   void set_entity_category(EntityCategory entity_category);
 
   // Get/set this entity's icon
-  const std::string &get_icon() const;
-  void set_icon(const std::string &name);
+  StringRef get_icon() const;
+  void set_icon(const char *icon);
 
  protected:
   /// The hash_base() function has been deprecated. It is kept in this
@@ -51,10 +56,13 @@ class EntityBase {
   virtual uint32_t hash_base() { return 0L; }
   void calc_object_id_();
 
-  std::string name_;
-  std::string object_id_;
-  std::string icon_;
-  uint32_t object_id_hash_;
+  StringRef name_;
+  const char *object_id_c_str_{nullptr};
+  const char *icon_c_str_{nullptr};
+  uint32_t object_id_hash_{0};
+  /// Whether name_ and object_id_c_str_ point to heap copies owned by this Entity.
+  bool has_own_name_{false};
+  bool has_own_object_id_{false};
   bool internal_{false};
   bool disabled_by_default_{false};
   EntityCategory entity_category_{ENTITY_CATEGORY_NONE};
@@ -91,6 +91,22 @@ uint32_t fnv1_hash(const std::string &str) {
   }
   return hash;
 }
+uint32_t fnv1_hash(const char *str) {
+  uint32_t hash = 2166136261UL;
+  for (; *str != '\0'; str++) {
+    hash *= 16777619UL;
+    hash ^= *str;
+  }
+  return hash;
+}
+uint32_t fnv1_hash(const uint8_t *data, size_t len) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < len; i++) {
+    hash *= 16777619UL;
+    hash ^= data[i];
+  }
+  return hash;
+}
 
 uint32_t random_uint32() {
 #ifdef USE_ESP32
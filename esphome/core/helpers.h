@@ -154,6 +154,10 @@ uint16_t crc16(const uint8_t *data, uint8_t len);
 
 /// Calculate a FNV-1 hash of \p str.
 uint32_t fnv1_hash(const std::string &str);
+/// Calculate a FNV-1 hash of the null-terminated string \p str.
+uint32_t fnv1_hash(const char *str);
+/// Calculate a FNV-1 hash of the \p len bytes at \p data.
+uint32_t fnv1_hash(const uint8_t *data, size_t len);
 
 /// Return a random 32-bit unsigned integer.
 uint32_t random_uint32();
@@ -25,6 +25,9 @@ class Scheduler {
 
   void process_to_add();
 
+  /// Approximate number of pending timeouts and intervals.
+  size_t size() const { return this->items_.size() + this->to_add_.size() - this->to_remove_; }
+
  protected:
   struct SchedulerItem {
     Component *component;
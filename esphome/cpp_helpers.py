@@ -12,6 +12,7 @@ from esphome.const import (
 )
 
 from esphome.core import coroutine, ID, CORE
+from esphome.helpers import sanitize, snake_case
 from esphome.types import ConfigType, ConfigFragmentType
 from esphome.cpp_generator import add, get_variable
 from esphome.cpp_types import App
@@ -97,6 +98,7 @@ async def register_parented(var, value):
 async def setup_entity(var, config):
     """Set up generic properties of an Entity"""
     add(var.set_name(config[CONF_NAME]))
+    add(var.set_object_id(sanitize(snake_case(config[CONF_NAME]))))
     add(var.set_disabled_by_default(config[CONF_DISABLED_BY_DEFAULT]))
     if CONF_INTERNAL in config:
         add(var.set_internal(config[CONF_INTERNAL]))
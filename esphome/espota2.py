@@ -2,9 +2,11 @@ import hashlib
 import logging
 import random
 import socket
+import struct
 import sys
 import time
 import gzip
+import zlib
 
 from esphome.core import EsphomeError
 from esphome.helpers import is_ip_address, resolve_ip_address
@@ -19,6 +21,8 @@ RESPONSE_BIN_MD5_OK = 67
 RESPONSE_RECEIVE_OK = 68
 RESPONSE_UPDATE_END_OK = 69
 RESPONSE_SUPPORTS_COMPRESSION = 70
+RESPONSE_FEATURES = 71
+RESPONSE_DELTA_SIGNATURE = 72
 
 RESPONSE_ERROR_MAGIC = 128
 RESPONSE_ERROR_UPDATE_PREPARE = 129
@@ -32,6 +36,8 @@ RESPONSE_ERROR_ESP8266_NOT_ENOUGH_SPACE = 136
 RESPONSE_ERROR_ESP32_NOT_ENOUGH_SPACE = 137
 RESPONSE_ERROR_NO_UPDATE_PARTITION = 138
 RESPONSE_ERROR_MD5_MISMATCH = 139
+RESPONSE_ERROR_DELTA_INVALID = 141
+RESPONSE_ERROR_DECOMPRESSION = 142
 RESPONSE_ERROR_UNKNOWN = 255
 
 OTA_VERSION_1_0 = 1
@@ -39,6 +45,12 @@ OTA_VERSION_1_0 = 1
 MAGIC_BYTES = [0x6C, 0x26, 0xF7, 0x5C, 0x45]
 
 FEATURE_SUPPORTS_COMPRESSION = 0x01
+FEATURE_SUPPORTS_DELTA = 0x02
+FEATURE_SUPPORTS_DEFLATE = 0x04
+
+DELTA_OP_COPY = 0x01
+DELTA_OP_DATA = 0x02
+DELTA_STRONG_SIZE = 8
 
 _LOGGER = logging.getLogger(__name__)
 
@@ -71,6 +83,10 @@ class OTAError(EsphomeError):
     pass
 
 
+class DeltaOTAError(OTAError):
+    """A delta update failed, a full image can still be uploaded."""
+
+
 def recv_decode(sock, amount, decode=True):
     data = sock.recv(amount)
     if not decode:
@@ -162,6 +178,12 @@ def check_error(data, expect):
             "Error: Application MD5 code mismatch. Please try again "
             "or flash over USB with a good quality cable."
         )
+    if dat == RESPONSE_ERROR_DELTA_INVALID:
+        raise OTAError(
+            "Error: The ESP could not apply the delta update to its running firmware."
+        )
+    if dat == RESPONSE_ERROR_DECOMPRESSION:
+        raise OTAError("Error: The ESP could not decompress the update.")
     if dat == RESPONSE_ERROR_UNKNOWN:
         raise OTAError("Unknown error from ESP")
     if not isinstance(expect, (list, tuple)):
@@ -184,7 +206,121 @@ def send_check(sock, data, msg):
         raise OTAError(f"Error sending {msg}: {err}") from err
 
 
-def perform_ota(sock, password, file_handle, filename):
+def encode_varint(value):
+    data = bytearray()
+    while value > 0x7F:
+        data.append((value & 0x7F) | 0x80)
+        value >>= 7
+    data.append(value)
+    return data
+
+
+def compute_delta(image, block_size, base_size, signature):
+    """Compute a patch that turns the running image described by signature into image.
+
+    signature holds the weak checksum and MD5 prefix of each block of the running
+    image. The weak checksum is rolled over image to find blocks that occur at any
+    offset, like rsync does. Matching blocks become copies from the running image,
+    everything else is sent literally.
+    """
+    blocks = {}
+    # a partial last block can only match at the very end, don't bother
+    for index in range(base_size // block_size):
+        weak, strong = signature[index]
+        blocks.setdefault(weak, []).append((index, strong))
+
+    patch = bytearray()
+    run = None
+
+    def flush_run():
+        if run is not None:
+            patch.append(DELTA_OP_COPY)
+            patch.extend(encode_varint(run[0]))
+            patch.extend(encode_varint(run[1]))
+
+    def add_literal(data):
+        if data:
+            patch.append(DELTA_OP_DATA)
+            patch.extend(encode_varint(len(data)))
+            patch.extend(data)
+
+    size = len(image)
+    literal_start = 0
+    pos = 0
+    s1 = s2 = 0
+    window_valid = False
+    while pos + block_size <= size:
+        if not window_valid:
+            s1 = s2 = 0
+            for byte in image[pos : pos + block_size]:
+                s1 += byte
+                s2 += s1
+            window_valid = True
+
+        match = None
+        candidates = blocks.get(((s2 & 0xFFFF) << 16) | (s1 & 0xFFFF))
+        if candidates is not None:
+            strong = hashlib.md5(image[pos : pos + block_size]).digest()
+            strong = strong[:DELTA_STRONG_SIZE]
+            for index, block_strong in candidates:
+                if block_strong != strong:
+                    continue
+                match = index
+                if run is not None and index == run[0] + run[1]:
+                    break
+
+        if match is not None:
+            if pos > literal_start:
+                flush_run()
+                run = None
+                add_literal(image[literal_start:pos])
+            if run is not None and match == run[0] + run[1]:
+                run[1] += 1
+            else:
+                flush_run()
+                run = [match, 1]
+            pos += block_size
+            literal_start = pos
+            window_valid = False
+            continue
+
+        if pos + block_size < size:
+            out_byte = image[pos]
+            s1 += image[pos + block_size] - out_byte
+            s2 += s1 - block_size * out_byte
+        pos += 1
+
+    if size > literal_start:
+        flush_run()
+        run = None
+        add_literal(image[literal_start:])
+    flush_run()
+    return bytes(patch)
+
+
+def receive_delta_patch(sock, file_contents):
+    block_size, base_size = struct.unpack(
+        ">II",
+        receive_exactly(
+            sock, 9, "delta signature", RESPONSE_DELTA_SIGNATURE, decode=False
+        )[1:],
+    )
+    block_count = (base_size + block_size - 1) // block_size
+    data = receive_exactly(
+        sock, block_count * 12, "delta signature", [], decode=False
+    )
+    signature = [
+        (
+            struct.unpack(">I", data[i * 12 : i * 12 + 4])[0],
+            data[i * 12 + 4 : i * 12 + 12],
+        )
+        for i in range(block_count)
+    ]
+    _LOGGER.info("Computing delta against the running firmware (%s bytes)", base_size)
+    return compute_delta(file_contents, block_size, base_size, signature)
+
+
+def perform_ota(sock, password, file_handle, filename, allow_delta=True):
     file_contents = file_handle.read()
     file_size = len(file_contents)
     _LOGGER.info("Uploading %s (%s bytes)", filename, file_size)
@@ -198,12 +334,37 @@ def perform_ota(sock, password, file_handle, filename):
         raise OTAError(f"Unsupported OTA version {version}")
 
     # Features
-    send_check(sock, FEATURE_SUPPORTS_COMPRESSION, "features")
-    features = receive_exactly(
-        sock, 1, "features", [RESPONSE_HEADER_OK, RESPONSE_SUPPORTS_COMPRESSION]
-    )[0]
-
-    if features == RESPONSE_SUPPORTS_COMPRESSION:
+    client_features = FEATURE_SUPPORTS_COMPRESSION | FEATURE_SUPPORTS_DEFLATE
+    if allow_delta:
+        client_features |= FEATURE_SUPPORTS_DELTA
+    send_check(sock, client_features, "features")
+    (features,) = receive_exactly(
+        sock,
+        1,
+        "features",
+        [RESPONSE_HEADER_OK, RESPONSE_SUPPORTS_COMPRESSION, RESPONSE_FEATURES],
+    )
+    device_features = 0
+    window_bits = None
+    if features == RESPONSE_FEATURES:
+        (device_features,) = receive_exactly(sock, 1, "device features", [])
+        if device_features & FEATURE_SUPPORTS_DEFLATE:
+            (window_bits,) = receive_exactly(sock, 1, "deflate window", [])
+    elif features == RESPONSE_SUPPORTS_COMPRESSION:
+        device_features = FEATURE_SUPPORTS_COMPRESSION
+
+    def deflate(data):
+        # raw deflate, the device inflates it with a window of 2^window_bits bytes
+        compressor = zlib.compressobj(9, zlib.DEFLATED, -window_bits)
+        return compressor.compress(data) + compressor.flush()
+
+    # The features used for this update
+    mode = 0
+    if device_features & FEATURE_SUPPORTS_DEFLATE:
+        upload_contents = deflate(file_contents)
+        mode |= FEATURE_SUPPORTS_DEFLATE
+        _LOGGER.info("Compressed to %s bytes", len(upload_contents))
+    elif device_features & FEATURE_SUPPORTS_COMPRESSION:
         upload_contents = gzip.compress(file_contents, compresslevel=9)
         _LOGGER.info("Compressed to %s bytes", len(upload_contents))
     else:
@@ -234,22 +395,55 @@ def perform_ota(sock, password, file_handle, filename):
         send_check(sock, result, "auth result")
         receive_exactly(sock, 1, "auth result", RESPONSE_AUTH_OK)
 
-    upload_size = len(upload_contents)
-    upload_size_encoded = [
-        (upload_size >> 24) & 0xFF,
-        (upload_size >> 16) & 0xFF,
-        (upload_size >> 8) & 0xFF,
-        (upload_size >> 0) & 0xFF,
+    if device_features & FEATURE_SUPPORTS_DELTA:
+        patch = receive_delta_patch(sock, file_contents)
+        if mode & FEATURE_SUPPORTS_DEFLATE:
+            patch = deflate(patch)
+        if len(patch) < len(upload_contents):
+            _LOGGER.info("Delta update is %s bytes", len(patch))
+            upload_contents = patch
+            mode |= FEATURE_SUPPORTS_DELTA
+        else:
+            _LOGGER.info("Delta update is not smaller, uploading the full image")
+    if device_features & (FEATURE_SUPPORTS_DELTA | FEATURE_SUPPORTS_DEFLATE):
+        send_check(sock, mode, "update mode")
+
+    # The device checks the image it reconstructs from a delta or deflate stream
+    image = file_contents if mode else upload_contents
+    image_size = len(image)
+    image_size_encoded = [
+        (image_size >> 24) & 0xFF,
+        (image_size >> 16) & 0xFF,
+        (image_size >> 8) & 0xFF,
+        (image_size >> 0) & 0xFF,
     ]
-    send_check(sock, upload_size_encoded, "binary size")
+    send_check(sock, image_size_encoded, "binary size")
     receive_exactly(sock, 1, "binary size", RESPONSE_UPDATE_PREPARE_OK)
 
-    upload_md5 = hashlib.md5(upload_contents).hexdigest()
-    _LOGGER.debug("MD5 of upload is %s", upload_md5)
+    image_md5 = hashlib.md5(image).hexdigest()
+    _LOGGER.debug("MD5 of upload is %s", image_md5)
 
-    send_check(sock, upload_md5, "file checksum")
+    send_check(sock, image_md5, "file checksum")
     receive_exactly(sock, 1, "file checksum", RESPONSE_BIN_MD5_OK)
 
+    if mode:
+        send_check(sock, struct.pack(">I", len(upload_contents)), "transfer size")
+    try:
+        send_upload(sock, upload_contents)
+    except OTAError as err:
+        if mode & FEATURE_SUPPORTS_DELTA:
+            raise DeltaOTAError(str(err)) from err
+        raise
+
+    _LOGGER.info("OTA successful")
+
+    # Do not connect logs until it is fully on
+    time.sleep(1)
+
+
+def send_upload(sock, upload_contents):
+    upload_size = len(upload_contents)
+
     # Disable nodelay for transfer
     sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 0)
     # Limit send buffer (usually around 100kB) in order to have progress bar
@@ -284,11 +478,6 @@ def perform_ota(sock, password, file_handle, filename):
     receive_exactly(sock, 1, "Update end", RESPONSE_UPDATE_END_OK)
     send_check(sock, RESPONSE_OK, "end acknowledgement")
 
-    _LOGGER.info("OTA successful")
-
-    # Do not connect logs until it is fully on
-    time.sleep(1)
-
 
 def run_ota_impl_(remote_host, remote_port, password, filename):
     if is_ip_address(remote_host):
@@ -310,25 +499,33 @@ def run_ota_impl_(remote_host, remote_port, password, filename):
             raise OTAError(err) from err
         _LOGGER.info(" -> %s", ip)
 
-    sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-    sock.settimeout(10.0)
-    try:
-        sock.connect((ip, remote_port))
-    except OSError as err:
-        sock.close()
-        _LOGGER.error("Connecting to %s:%s failed: %s", remote_host, remote_port, err)
-        return 1
-
+    allow_delta = True
     with open(filename, "rb") as file_handle:
-        try:
-            perform_ota(sock, password, file_handle, filename)
-        except OTAError as err:
-            _LOGGER.error(str(err))
-            return 1
-        finally:
-            sock.close()
-
-    return 0
+        while True:
+            sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            sock.settimeout(10.0)
+            try:
+                sock.connect((ip, remote_port))
+            except OSError as err:
+                sock.close()
+                _LOGGER.error(
+                    "Connecting to %s:%s failed: %s", remote_host, remote_port, err
+                )
+                return 1
+
+            try:
+                perform_ota(sock, password, file_handle, filename, allow_delta)
+                return 0
+            except DeltaOTAError as err:
+                _LOGGER.warning("%s", err)
+                _LOGGER.warning("Delta update failed, retrying with the full image")
+                allow_delta = False
+                file_handle.seek(0)
+            except OTAError as err:
+                _LOGGER.error(str(err))
+                return 1
+            finally:
+                sock.close()
 
 
 def run_ota(remote_host, remote_port, password, filename):
@@ -3,6 +3,7 @@ from contextlib import suppress
 
 import logging
 import os
+import string
 from pathlib import Path
 from typing import Union
 import tempfile
@@ -59,6 +60,21 @@ def cpp_string_escape(string, encoding="utf-8"):
     return f'"{result}"'
 
 
+def snake_case(value):
+    """Same behaviour as `str_snake_case` in helpers.cpp, only ASCII letters are lowercased."""
+    return "".join(
+        chr(ord(c) + 32) if "A" <= c <= "Z" else "_" if c == " " else c for c in value
+    )
+
+
+_SANITIZE_ALLOWED = frozenset(string.ascii_letters + string.digits + "-_")
+
+
+def sanitize(value):
+    """Same behaviour as `str_sanitize` in helpers.cpp."""
+    return "".join(c for c in value if c in _SANITIZE_ALLOWED)
+
+
 def run_system_command(*args):
     import subprocess
 
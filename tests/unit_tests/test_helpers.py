@@ -229,3 +229,31 @@ def test_file_compare(fixture_path, file1, file2, expected):
     actual = helpers.file_compare(path1, path2)
 
     assert actual == expected
+
+
+@pytest.mark.parametrize(
+    "text, expected",
+    (
+        ("foo", "foo"),
+        ("Living Room", "living_room"),
+        ("Ärger Sensor", "Ärger_sensor"),
+    ),
+)
+def test_snake_case(text, expected):
+    actual = helpers.snake_case(text)
+
+    assert actual == expected
+
+
+@pytest.mark.parametrize(
+    "text, expected",
+    (
+        ("foo_bar-42", "foo_bar-42"),
+        ("living_room (2)", "living_room2"),
+        ("Ärger_sensor", "rger_sensor"),
+    ),
+)
+def test_sanitize(text, expected):
+    actual = helpers.sanitize(text)
+
+    assert actual == expected